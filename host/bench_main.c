@@ -0,0 +1,47 @@
+/*
+ * Host-native benchmark runner for the rendering primitives.
+ * Usage: tetris_bench [iterations]
+ * Prints a CSV table of per-call timings in nanoseconds.
+ */
+#include <stdlib.h>
+
+#include "bench.h"
+
+/*
+ * Format the header of the results table as CSV.
+ */
+static int bench_format_header(char *buf, int len) {
+  return snprintf(buf, len, "name,iterations,units,min,avg,max");
+}
+
+/*
+ * Format one row of the results table as CSV.
+ */
+static int bench_format_result(char *buf, int len, const bench_result_t *res) {
+  uint32_t avg = res->iterations ? (res->total / res->iterations) : 0;
+  return snprintf(buf, len, "%s,%lu,%s,%lu,%lu,%lu",
+                  res->name,
+                  (unsigned long)res->iterations,
+                  BENCH_UNITS,
+                  (unsigned long)res->min,
+                  (unsigned long)avg,
+                  (unsigned long)res->max);
+}
+
+int main(int argc, char **argv) {
+  char line[128];
+  uint16_t iterations = 1000;
+  uint8_t i;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+  game_init();
+  bench_run_all(iterations);
+  bench_format_header(line, sizeof(line));
+  puts(line);
+  for (i = 0; i < bench_num_results; ++i) {
+    bench_format_result(line, sizeof(line), &bench_results[i]);
+    puts(line);
+  }
+  return 0;
+}
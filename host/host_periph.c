@@ -0,0 +1,218 @@
+#include <time.h>
+
+#include "global.h"
+#include "interrupts_c.h"
+
+// Host-native peripheral stub definitions.
+TIM_TypeDef         host_TIM2;
+TIM_TypeDef         host_TIM3;
+RCC_TypeDef         host_RCC;
+EXTI_TypeDef        host_EXTI;
+SYSCFG_TypeDef      host_SYSCFG;
+GPIO_TypeDef        host_GPIOA;
+GPIO_TypeDef        host_GPIOB;
+DMA_TypeDef         host_DMA1;
+DMA_Channel_TypeDef host_DMA1_Channel[5];
+I2C_TypeDef         host_I2C1;
+SysTick_Type        host_SysTick;
+
+uint8_t  host_gddram[1024];
+uint32_t host_i2c_bytes;
+uint32_t host_i2c_transfers;
+uint32_t host_i2c_errors;
+uint8_t  host_i2c_chunk_log[HOST_I2C_CHUNK_LOG_LEN];
+uint16_t host_i2c_chunk_count;
+
+/*
+ * Note the 'NBYTES' value of a chunk which is starting.
+ */
+static void host_log_chunk(uint32_t nbytes) {
+  if (host_i2c_chunk_count < HOST_I2C_CHUNK_LOG_LEN) {
+    host_i2c_chunk_log[host_i2c_chunk_count] = nbytes;
+  }
+  ++host_i2c_chunk_count;
+}
+
+/*
+ * A minimal model of the SSD1306's I2C interface.
+ * Only the parts which the firmware relies on after startup
+ * are modeled: the control byte, the column/page address
+ * commands, and horizontal-addressing-mode data writes.
+ */
+static uint8_t ssd_is_data;
+static uint8_t ssd_cmd[3];
+static uint8_t ssd_cmd_len;
+static uint8_t ssd_col_start = 0;
+static uint8_t ssd_col_end   = 127;
+static uint8_t ssd_page_start = 0;
+static uint8_t ssd_page_end   = 7;
+static uint8_t ssd_col;
+static uint8_t ssd_page;
+
+static uint8_t ssd1306_cmd_args(uint8_t cmd) {
+  switch (cmd) {
+    case 0x21:
+    case 0x22:
+      return 2;
+    case 0x20:
+    case 0x81:
+    case 0x8D:
+    case 0xA8:
+    case 0xD3:
+    case 0xD5:
+    case 0xD9:
+    case 0xDA:
+    case 0xDB:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static void ssd1306_model_cmd_byte(uint8_t dat) {
+  ssd_cmd[ssd_cmd_len++] = dat;
+  if (ssd_cmd_len <= ssd1306_cmd_args(ssd_cmd[0])) { return; }
+  if (ssd_cmd[0] == 0x21) {
+    ssd_col_start = ssd_cmd[1] & 0x7F;
+    ssd_col_end   = ssd_cmd[2] & 0x7F;
+    ssd_col       = ssd_col_start;
+  }
+  else if (ssd_cmd[0] == 0x22) {
+    ssd_page_start = ssd_cmd[1] & 0x07;
+    ssd_page_end   = ssd_cmd[2] & 0x07;
+    ssd_page       = ssd_page_start;
+  }
+  ssd_cmd_len = 0;
+}
+
+static void ssd1306_model_data_byte(uint8_t dat) {
+  host_gddram[(ssd_page * 128) + ssd_col] = dat;
+  if (ssd_col >= ssd_col_end) {
+    ssd_col = ssd_col_start;
+    ssd_page = (ssd_page >= ssd_page_end) ? ssd_page_start : ssd_page + 1;
+  }
+  else {
+    ++ssd_col;
+  }
+}
+
+static void ssd1306_model_byte(uint8_t dat, uint8_t first) {
+  if (first) {
+    // 'Co' is never set, so the control byte applies to
+    // the whole transfer: 0x00 = 'Command', 0x40 = 'Data'.
+    ssd_is_data = (dat & 0x40);
+    ssd_cmd_len = 0;
+  }
+  else if (ssd_is_data) {
+    ssd1306_model_data_byte(dat);
+  }
+  else {
+    ssd1306_model_cmd_byte(dat);
+  }
+}
+
+/*
+ * Run the simulated I2C1 peripheral and its TX DMA channel.
+ * Each transfer starts when the firmware sets the 'START' bit;
+ * the first byte comes from TXDR, and the rest come from the DMA
+ * channel. 'NBYTES' reloads and the I2C 'stop' event call the
+ * real interrupt handler, which may
+ * start the next transfer. Anything which would hang or corrupt
+ * a transfer on the real peripheral is counted as an error.
+ */
+void host_run_i2c(void) {
+  DMA_Channel_TypeDef *dma = I2C1_TX_DMA_CHANNEL;
+  while (host_I2C1.CR2 & I2C_CR2_START) {
+    host_I2C1.CR2 &= ~(I2C_CR2_START);
+    ++host_i2c_transfers;
+    uint8_t  *buf = (uint8_t *)(uintptr_t)dma->CMAR;
+    uint32_t dma_left = dma->CNDTR;
+    uint32_t chunk_left = (host_I2C1.CR2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+    uint8_t  first = 1;
+    host_log_chunk(chunk_left);
+    uint8_t  dat;
+    while (1) {
+      if (chunk_left == 0) {
+        if (!(host_I2C1.CR2 & I2C_CR2_RELOAD)) { break; }
+        // 'Transfer complete reload'; the handler must
+        // write a new 'NBYTES' value.
+        host_I2C1.ISR |= I2C_ISR_TCR;
+        I2C1_IRQ_handler();
+        host_I2C1.ISR &= ~(I2C_ISR_TCR);
+        chunk_left = (host_I2C1.CR2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+        host_log_chunk(chunk_left);
+        if (chunk_left == 0) {
+          ++host_i2c_errors;
+          break;
+        }
+        continue;
+      }
+      if (first) {
+        dat = host_I2C1.TXDR & 0xFF;
+      }
+      else {
+        if (!(dma->CCR & DMA_CCR_EN) ||
+            !(host_I2C1.CR1 & I2C_CR1_TXDMAEN) ||
+            dma_left == 0) {
+          ++host_i2c_errors;
+          break;
+        }
+        dat = *buf++;
+        dma->CNDTR = --dma_left;
+      }
+      ssd1306_model_byte(dat, first);
+      first = 0;
+      ++host_i2c_bytes;
+      --chunk_left;
+    }
+    if (dma_left != 0) {
+      // The DMA channel had bytes left over.
+      ++host_i2c_errors;
+    }
+    // 'AUTOEND' sends the stop condition.
+    host_I2C1.ISR |= I2C_ISR_STOPF;
+    I2C1_IRQ_handler();
+    host_I2C1.ISR &= ~(I2C_ISR_STOPF);
+  }
+}
+
+/*
+ * Read the host's monotonic clock in microseconds, for measuring
+ * how long the firmware's code takes to run on the host. This is
+ * separate from the simulated SysTick clock, which only moves
+ * when the script lets a millisecond pass.
+ */
+uint32_t host_run_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((ts.tv_sec * 1000000ULL) + (ts.tv_nsec / 1000));
+}
+
+/*
+ * Deliver a SysTick interrupt, if it is running: 1ms passes.
+ * The counter is left at the start of the next millisecond.
+ */
+uint8_t host_tick_systick(void) {
+  if (!(host_SysTick.CTRL & SysTick_CTRL_ENABLE_Msk) ||
+      !(host_SysTick.CTRL & SysTick_CTRL_TICKINT_Msk)) {
+    return 0;
+  }
+  host_SysTick.VAL = host_SysTick.LOAD;
+  SysTick_handler();
+  return 1;
+}
+
+/*
+ * Set the button input pins; the buttons have pullups,
+ * so held buttons read low.
+ */
+void host_set_buttons(uint8_t held) {
+  host_GPIOA.IDR = (host_GPIOA.IDR | BUTTON_ALL) & ~(held & BUTTON_ALL);
+}
+
+/*
+ * Set the free-running TIM3 counter.
+ */
+void host_set_tim3(uint16_t cnt) {
+  host_TIM3.CNT = cnt;
+}
@@ -0,0 +1,90 @@
+#ifndef _VVC_HOST_PERIPH_H
+#define _VVC_HOST_PERIPH_H
+
+/*
+ * Host-native peripheral stubs.
+ * The device headers point each peripheral at its address on
+ * the chip; for host builds, those are re-pointed at plain
+ * structs in RAM so that the game core can run on a PC.
+ * Nothing happens in these 'registers' on its own; the host
+ * simulator drives them (see 'host_periph.c').
+ */
+#include <stdint.h>
+
+#undef TIM2
+#undef TIM3
+#undef RCC
+#undef EXTI
+#undef SYSCFG
+#undef GPIOA
+#undef GPIOB
+#undef DMA1
+#undef DMA1_Channel1
+#undef DMA1_Channel2
+#undef DMA1_Channel3
+#undef DMA1_Channel4
+#undef DMA1_Channel5
+#undef I2C1
+#undef SysTick
+
+extern TIM_TypeDef         host_TIM2;
+extern TIM_TypeDef         host_TIM3;
+extern RCC_TypeDef         host_RCC;
+extern EXTI_TypeDef        host_EXTI;
+extern SYSCFG_TypeDef      host_SYSCFG;
+extern GPIO_TypeDef        host_GPIOA;
+extern GPIO_TypeDef        host_GPIOB;
+extern DMA_TypeDef         host_DMA1;
+extern DMA_Channel_TypeDef host_DMA1_Channel[5];
+extern I2C_TypeDef         host_I2C1;
+extern SysTick_Type        host_SysTick;
+
+#define TIM2          (&host_TIM2)
+#define TIM3          (&host_TIM3)
+#define RCC           (&host_RCC)
+#define EXTI          (&host_EXTI)
+#define SYSCFG        (&host_SYSCFG)
+#define GPIOA         (&host_GPIOA)
+#define GPIOB         (&host_GPIOB)
+#define DMA1          (&host_DMA1)
+#define DMA1_Channel1 (&host_DMA1_Channel[0])
+#define DMA1_Channel2 (&host_DMA1_Channel[1])
+#define DMA1_Channel3 (&host_DMA1_Channel[2])
+#define DMA1_Channel4 (&host_DMA1_Channel[3])
+#define DMA1_Channel5 (&host_DMA1_Channel[4])
+#define I2C1          (&host_I2C1)
+#define SysTick       (&host_SysTick)
+
+// There is no interrupt to wait for; the simulator steps the
+// clock itself.
+#define __WFI() ((void)0)
+
+// Simulated SSD1306 display RAM, in the same page layout
+// as the framebuffers.
+extern uint8_t host_gddram[1024];
+// Running totals of simulated I2C traffic.
+extern uint32_t host_i2c_bytes;
+extern uint32_t host_i2c_transfers;
+extern uint32_t host_i2c_errors;
+// The 'NBYTES' value of each chunk sent since the count was
+// last reset, in order. Only the first 'HOST_I2C_CHUNK_LOG_LEN'
+// are kept, but all of them are counted.
+#define HOST_I2C_CHUNK_LOG_LEN (32)
+extern uint8_t  host_i2c_chunk_log[HOST_I2C_CHUNK_LOG_LEN];
+extern uint16_t host_i2c_chunk_count;
+
+// Run the simulated I2C1 peripheral and its DMA channel
+// until there are no more transfers pending.
+void host_run_i2c(void);
+// Deliver a SysTick interrupt (1ms of the system clock),
+// if it is running. Returns 1 if it was delivered.
+uint8_t host_tick_systick(void);
+// Read the host's real time in microseconds, for run times.
+uint32_t host_run_us(void);
+// Set which buttons are held down, as 'BUTTON_*' bits; the
+// GPIOA input pins read low for held buttons.
+void host_set_buttons(uint8_t held);
+// Set the 'free-running' TIM3 counter used as a PRNG.
+void host_set_tim3(uint16_t cnt);
+
+#endif
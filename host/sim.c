@@ -0,0 +1,354 @@
+/*
+ * Headless simulator for the Tetris game core.
+ * Usage: tetris_sim [script]
+ * Commands are read from the script file (or stdin), one per line:
+ *   seed N          Seed the simulated TIM3 'PRNG' counter.
+ *   press BUTTON    Press and release a button: left, up, down,
+ *                   right, b, a.
+ *   hold BUTTON     Hold a button down.
+ *   release BUTTON  Let go of a held button.
+ *   bounce BUTTON   Press and release a button with switch bounce.
+ *   ms [N]          Let N ms pass, running the firmware's scheduler
+ *                   once per ms as the main loop would: the buttons
+ *                   are sampled, and frames are drawn and sent as
+ *                   the tasks decide. ('run' does the same.)
+ *   tick [N]        Let time pass up to the end of N 60Hz game
+ *                   frames, or about N/60 s outside of a game.
+ *   frame [N]       Apply the queued events, and draw and present
+ *                   N frames right away.
+ *   dump            Print the simulated display.
+ *   grid            Print the Tetris grid.
+ *   state           Print the game state and current brick.
+ *   stats           Print the simulated I2C traffic totals.
+ *   latency         Print the input latency histograms as CSV.
+ *   sched           Print the scheduler's task counters as CSV.
+ *   fps             Print the last window's frame statistics.
+ * Blank lines and lines starting with '#' are ignored.
+ * Simulated time only moves when the script lets a millisecond
+ * pass, so a script always plays out the same way. The run times
+ * in 'sched' and 'fps' are measured on the host's real clock, and
+ * change from run to run; the latency stages are simulated time.
+ * After every ms and frame, the display RAM is compared with
+ * the 'front' framebuffer; the exit code is non-zero if they
+ * ever differ, or if the simulated I2C peripheral saw an error.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "global.h"
+#include "util_c.h"
+#include "interrupts_c.h"
+#include "peripherals.h"
+
+// How long 'press' holds a button down, and then leaves it up.
+#define SIM_PRESS_MS (20)
+
+static uint32_t sim_seed = 1;
+static uint32_t sim_frames;
+static uint32_t sim_mismatches;
+
+/*
+ * Step the TIM3 'PRNG' counter. The firmware reads the low 3 bits
+ * for new brick types and spins while they are 7, which would
+ * never end on a counter that doesn't move; so skip those values.
+ */
+static void sim_step_prng(void) {
+  sim_seed = (sim_seed * 1103515245) + 12345;
+  uint16_t cnt = (sim_seed >> 16) & 0xFFFF;
+  if ((cnt & 0x7) == 0x7) { cnt ^= 0x1; }
+  host_set_tim3(cnt);
+}
+
+static void sim_frame(void) {
+  game_process_events();
+  draw_frame();
+  oled_present(I2C1);
+  oled_present_pending = 0;
+  host_run_i2c();
+  ++sim_frames;
+  if (memcmp(host_gddram, oled_fb_front, OLED_FB_SIZE) != 0) {
+    ++sim_mismatches;
+    printf("frame %u: display does not match the framebuffer\n",
+           (unsigned)sim_frames);
+  }
+}
+
+// Buttons which the script is holding down.
+static uint8_t sim_held;
+
+static uint8_t sim_button(const char *button) {
+  if (strcmp(button, "left") == 0)  { return BUTTON_LEFT; }
+  if (strcmp(button, "up") == 0)    { return BUTTON_UP; }
+  if (strcmp(button, "down") == 0)  { return BUTTON_DOWN; }
+  if (strcmp(button, "right") == 0) { return BUTTON_RIGHT; }
+  if (strcmp(button, "b") == 0)     { return BUTTON_B; }
+  if (strcmp(button, "a") == 0)     { return BUTTON_A; }
+  return 0;
+}
+
+// Milliseconds owed to 'tick' outside of a game, in 60ths
+// of a millisecond.
+static uint32_t sim_frame_ms;
+
+// Let 'ms' milliseconds pass, running the firmware's scheduler
+// once per ms as the main loop would; the tasks sample the
+// buttons, run the game, and draw and send frames as they are
+// released.
+static void sim_ms(int ms) {
+  while (ms-- > 0) {
+    host_tick_systick();
+    sched_poll();
+    host_run_i2c();
+    if (memcmp(host_gddram, oled_fb_front, OLED_FB_SIZE) != 0) {
+      ++sim_mismatches;
+      printf("%lu ms: display does not match the framebuffer\n",
+             (unsigned long)clock_ms);
+    }
+  }
+}
+
+/*
+ * Press and release a button, holding it (and then leaving it)
+ * for long enough to get through the debouncing. With 'bounce'
+ * set, the contacts chatter for a few ms at each edge.
+ */
+static void sim_press(uint8_t button, uint8_t bounce) {
+  int i;
+  for (i = 0; bounce && i < 3; ++i) {
+    host_set_buttons(sim_held | button);
+    sim_ms(1);
+    host_set_buttons(sim_held);
+    sim_ms(1);
+  }
+  host_set_buttons(sim_held | button);
+  sim_ms(SIM_PRESS_MS);
+  for (i = 0; bounce && i < 3; ++i) {
+    host_set_buttons(sim_held);
+    sim_ms(1);
+    host_set_buttons(sim_held | button);
+    sim_ms(1);
+  }
+  host_set_buttons(sim_held);
+  sim_ms(SIM_PRESS_MS);
+}
+
+/*
+ * Format the header of the task table as CSV.
+ */
+static int sched_format_header(char *buf, int len) {
+  return snprintf(buf, len, "task,period_us,runs,overruns,skipped,max_us");
+}
+
+/*
+ * Format one task's counters as a row of CSV.
+ */
+static int sched_format_task(char *buf, int len, uint8_t task) {
+  const sched_task_t *t = &sched_tasks[task];
+  return snprintf(buf, len, "%s,%lu,%lu,%lu,%lu,%lu",
+                  t->def->name,
+                  (unsigned long)t->def->period_us,
+                  (unsigned long)t->runs,
+                  (unsigned long)t->overruns,
+                  (unsigned long)t->skipped,
+                  (unsigned long)t->max_us);
+}
+
+// The latency stages, in the order of the histograms.
+static const char *LATENCY_STAGE_NAMES[LATENCY_STAGES] = {
+  "input", "render", "display", "total"
+};
+
+/*
+ * Format the header row of the histogram table as CSV.
+ * Each bucket column is named for the shortest time it counts.
+ */
+static int latency_format_header(char *buf, int len) {
+  int pos = snprintf(buf, len, "stage,count,units,min,avg,max");
+  uint8_t bucket;
+  for (bucket = 0; bucket < LATENCY_BUCKETS && pos < len; ++bucket) {
+    pos += snprintf(buf + pos, len - pos, ",%lu",
+                    (unsigned long)(bucket ? (1UL << bucket) : 0));
+  }
+  return pos;
+}
+
+/*
+ * Format one stage's histogram as a row of CSV.
+ */
+static int latency_format_hist(char *buf, int len, uint8_t stage) {
+  const latency_hist_t *hist = &latency_hists[stage];
+  uint32_t avg = hist->count ? (hist->total / hist->count) : 0;
+  int pos = snprintf(buf, len, "%s,%lu,us,%lu,%lu,%lu",
+                     LATENCY_STAGE_NAMES[stage],
+                     (unsigned long)hist->count,
+                     (unsigned long)(hist->count ? hist->min : 0),
+                     (unsigned long)avg,
+                     (unsigned long)hist->max);
+  uint8_t bucket;
+  for (bucket = 0; bucket < LATENCY_BUCKETS && pos < len; ++bucket) {
+    pos += snprintf(buf + pos, len - pos, ",%u",
+                    (unsigned)hist->buckets[bucket]);
+  }
+  return pos;
+}
+
+static void sim_dump(void) {
+  int x, y;
+  for (y = 0; y < 64; ++y) {
+    for (x = 0; x < 128; ++x) {
+      putchar((host_gddram[((y / 8) * 128) + x] & (1 << (y & 0x07))) ? '#' : '.');
+    }
+    putchar('\n');
+  }
+}
+
+static void sim_grid(void) {
+  int x, y;
+  for (y = 0; y < 20; ++y) {
+    for (x = 0; x < 10; ++x) {
+      if (tetris_grid[x][y] != TGRID_EMPTY) {
+        putchar('0' + tetris_grid[x][y]);
+      }
+      else {
+        putchar('.');
+      }
+    }
+    putchar('\n');
+  }
+}
+
+int main(int argc, char **argv) {
+  FILE *script = stdin;
+  char line[128];
+  char cmd[32];
+  char arg[32];
+  int line_num = 0;
+  if (argc > 1) {
+    script = fopen(argv[1], "r");
+    if (!script) {
+      perror(argv[1]);
+      return 2;
+    }
+  }
+
+  game_init();
+  clock_init();
+  host_set_buttons(0);
+  input_init();
+  sched_init();
+  sched_start(SCHED_TASK_INPUT);
+  sched_start(SCHED_TASK_RENDER);
+  sim_step_prng();
+
+  while (fgets(line, sizeof(line), script)) {
+    ++line_num;
+    arg[0] = '\0';
+    if (sscanf(line, "%31s %31s", cmd, arg) < 1 || cmd[0] == '#') {
+      continue;
+    }
+    int count = arg[0] ? atoi(arg) : 1;
+    if (strcmp(cmd, "seed") == 0) {
+      sim_seed = strtoul(arg, NULL, 0);
+      sim_step_prng();
+    }
+    else if (strcmp(cmd, "press") == 0 || strcmp(cmd, "bounce") == 0 ||
+             strcmp(cmd, "hold") == 0 || strcmp(cmd, "release") == 0) {
+      uint8_t button = sim_button(arg);
+      if (!button) {
+        fprintf(stderr, "line %d: unknown button '%s'\n", line_num, arg);
+        return 2;
+      }
+      if (strcmp(cmd, "hold") == 0) {
+        sim_held |= button;
+        host_set_buttons(sim_held);
+      }
+      else if (strcmp(cmd, "release") == 0) {
+        sim_held &= ~button;
+        host_set_buttons(sim_held);
+      }
+      else {
+        sim_press(button, cmd[0] == 'b');
+        sim_step_prng();
+      }
+    }
+    else if (strcmp(cmd, "ms") == 0 || strcmp(cmd, "run") == 0) {
+      sim_ms(count);
+    }
+    else if (strcmp(cmd, "tick") == 0) {
+      const sched_task_t *game = &sched_tasks[SCHED_TASK_GAME];
+      while (count-- > 0) {
+        if (game->enabled) {
+          // Run up to and including the next game frame.
+          uint32_t runs = game->runs;
+          while (game->enabled && game->runs == runs) {
+            sim_ms(1);
+          }
+        }
+        else {
+          sim_frame_ms += 1000;
+          sim_ms(sim_frame_ms / 60);
+          sim_frame_ms %= 60;
+        }
+        sim_step_prng();
+      }
+    }
+    else if (strcmp(cmd, "frame") == 0) {
+      while (count-- > 0) {
+        sim_frame();
+      }
+    }
+    else if (strcmp(cmd, "dump") == 0) {
+      sim_dump();
+    }
+    else if (strcmp(cmd, "grid") == 0) {
+      sim_grid();
+    }
+    else if (strcmp(cmd, "state") == 0) {
+      printf("state %u brick %u x %d y %d r %d "
+             "score %u lines %u level %u\n",
+             game_state, cur_block_type, cur_block_x,
+             cur_block_y, cur_block_r, (unsigned)tetris_score,
+             tetris_lines, tetris_level);
+    }
+    else if (strcmp(cmd, "stats") == 0) {
+      printf("frames %u i2c_transfers %u i2c_bytes %u i2c_errors %u\n",
+             (unsigned)sim_frames, (unsigned)host_i2c_transfers,
+             (unsigned)host_i2c_bytes, (unsigned)host_i2c_errors);
+    }
+    else if (strcmp(cmd, "sched") == 0) {
+      char row[128];
+      uint8_t task;
+      sched_format_header(row, sizeof(row));
+      puts(row);
+      for (task = 0; task < SCHED_NUM_TASKS; ++task) {
+        sched_format_task(row, sizeof(row), task);
+        puts(row);
+      }
+    }
+    else if (strcmp(cmd, "fps") == 0) {
+      printf("window %u frames %u skipped %u min_us %lu avg_us %lu max_us %lu\n",
+             (unsigned)frame_stats.window,
+             (unsigned)frame_stats.last_frames,
+             (unsigned)frame_stats.last_skipped,
+             (unsigned long)frame_stats.last_min_us,
+             (unsigned long)frame_stats.last_avg_us,
+             (unsigned long)frame_stats.last_max_us);
+    }
+    else if (strcmp(cmd, "latency") == 0) {
+      char row[192];
+      uint8_t stage;
+      latency_format_header(row, sizeof(row));
+      puts(row);
+      for (stage = 0; stage < LATENCY_STAGES; ++stage) {
+        latency_format_hist(row, sizeof(row), stage);
+        puts(row);
+      }
+    }
+    else {
+      fprintf(stderr, "line %d: unknown command '%s'\n", line_num, cmd);
+      return 2;
+    }
+  }
+  if (script != stdin) { fclose(script); }
+  return (sim_mismatches || host_i2c_errors) ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+#ifndef _VVC_HOST_TEST_H
+#define _VVC_HOST_TEST_H
+
+#include "global.h"
+#include "util_c.h"
+
+// Host-native tests for the firmware's core logic.
+// A failed check prints where it is and is counted, and the
+// test carries on; the runner's exit code is non-zero if any
+// check failed.
+extern uint32_t test_checks;
+extern uint32_t test_failures;
+#define TEST_CHECK(cond) do { \
+  ++test_checks; \
+  if (!(cond)) { \
+    ++test_failures; \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+  } \
+} while (0)
+
+void test_i2c_chunks(void);
+void test_grid_collisions(void);
+void test_grid_row_clears(void);
+void test_text_cache(void);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * Check the occupancy bitboard ('tetris_rows') against the
+ * per-cell logic which it replaced, which only looked at the
+ * byte-per-cell 'tetris_grid'.
+ */
+#include <string.h>
+
+#include "test.h"
+
+#define TEST_GRID_ROUNDS (200)
+
+static uint32_t test_grid_seed = 1;
+
+static uint32_t test_grid_rand(void) {
+  test_grid_seed = (test_grid_seed * 1103515245) + 12345;
+  return (test_grid_seed >> 16) & 0x7FFF;
+}
+
+/*
+ * Fill the grid at random, with about 'fill' in 8 cells filled,
+ * and some full rows; then build the bitboard from it.
+ */
+static void random_grid(uint8_t fill) {
+  uint8_t ix, iy;
+  for (iy = 0; iy < 20; ++iy) {
+    uint8_t full_row = ((test_grid_rand() & 0x7) == 0);
+    tetris_rows[iy] = 0x0000;
+    for (ix = 0; ix < 10; ++ix) {
+      if (full_row || (test_grid_rand() & 0x7) < fill) {
+        tetris_grid[ix][iy] = test_grid_rand() % 7;
+        tetris_rows[iy] |= (1 << ix);
+      }
+      else {
+        tetris_grid[ix][iy] = TGRID_EMPTY;
+      }
+    }
+  }
+}
+
+/*
+ * The old collision check: walk the brick's 4x4 mask a cell
+ * at a time, against the byte grid.
+ */
+static uint8_t ref_brick_fit(uint8_t type, int8_t r, int8_t xp, int8_t yp) {
+  int8_t grid_ix, grid_iy;
+  for (grid_ix = 0; grid_ix < 4; ++grid_ix) {
+    for (grid_iy = 0; grid_iy < 4; ++grid_iy) {
+      if ((yp+grid_iy >= 0) &&
+          (BRICKS[r][type].mask & (1 << (3-grid_ix+(3-grid_iy)*4))) &&
+          ((yp+grid_iy > 19) || (xp+grid_ix < 0) ||
+           (xp+grid_ix > 9) ||
+           (tetris_grid[xp+grid_ix][yp+grid_iy] != TGRID_EMPTY))) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/*
+ * The old check skipped cells above the top of the grid
+ * entirely, so it let bricks poke through the walls up there;
+ * the bitboard check always tests the walls.
+ */
+static uint8_t out_of_walls_above_top(uint8_t type, int8_t r,
+                                      int8_t xp, int8_t yp) {
+  uint8_t i;
+  for (i = 0; i < 4; ++i) {
+    int8_t x = xp + (BRICKS[r][type].cells[i] & 0x0F);
+    int8_t y = yp + (BRICKS[r][type].cells[i] >> 4);
+    if (y < 0 && (x < 0 || x > 9)) { return 1; }
+  }
+  return 0;
+}
+
+/*
+ * The old row clear: scan up from the bottom, and clear each
+ * full row by moving everything above it down by one.
+ */
+static uint8_t ref_clear_full_rows(unsigned char grid[10][20]) {
+  int8_t grid_iy = 19;
+  int8_t iy;
+  uint8_t grid_ix;
+  uint8_t num_cleared = 0;
+  while (grid_iy >= 0) {
+    uint8_t row_has_space = 0;
+    for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+      if (grid[grid_ix][grid_iy] == TGRID_EMPTY) {
+        row_has_space = 1;
+      }
+    }
+    if (row_has_space) {
+      --grid_iy;
+      continue;
+    }
+    for (iy = grid_iy; iy > 0; --iy) {
+      for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+        grid[grid_ix][iy] = grid[grid_ix][iy - 1];
+      }
+    }
+    for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+      grid[grid_ix][0] = TGRID_EMPTY;
+    }
+    ++num_cleared;
+  }
+  return num_cleared;
+}
+
+void test_grid_collisions(void) {
+  uint16_t round;
+  uint8_t type;
+  int8_t r, xp, yp;
+  uint32_t mismatches = 0;
+  for (round = 0; round < TEST_GRID_ROUNDS; ++round) {
+    random_grid(round & 0x7);
+    for (type = 0; type < 7; ++type) {
+      for (r = 0; r < 4; ++r) {
+        // Every position where some of the brick is on the grid.
+        for (xp = -3; xp <= 9; ++xp) {
+          for (yp = -3; yp <= 19; ++yp) {
+            uint8_t expect = ref_brick_fit(type, r, xp, yp) ||
+                             out_of_walls_above_top(type, r, xp, yp);
+            if (check_brick_fit(type, r, xp, yp) != expect) {
+              ++mismatches;
+            }
+            cur_block_type = type;
+            cur_block_r = r;
+            cur_block_x = xp;
+            cur_block_y = yp;
+            if (check_brick_pos(xp, yp) != expect ||
+                check_brick_rot(r) != expect) {
+              ++mismatches;
+            }
+          }
+        }
+      }
+    }
+  }
+  TEST_CHECK(mismatches == 0);
+}
+
+void test_grid_row_clears(void) {
+  static unsigned char ref_grid[10][20];
+  uint16_t round;
+  uint8_t ix, iy;
+  uint8_t cleared_rows[4];
+  for (round = 0; round < TEST_GRID_ROUNDS; ++round) {
+    random_grid(4 + (round & 0x3));
+    // At most 4 rows can fill up at once.
+    uint8_t full = 0;
+    for (iy = 20; iy-- > 0;) {
+      if (tetris_rows[iy] == TROW_FULL && ++full > 4) {
+        tetris_grid[round % 10][iy] = TGRID_EMPTY;
+        tetris_rows[iy] &= ~(1 << (round % 10));
+      }
+    }
+    memcpy(ref_grid, tetris_grid, sizeof(ref_grid));
+    uint8_t expect_rows[4];
+    uint8_t expect_cleared = 0;
+    for (iy = 20; iy-- > 0;) {
+      if (tetris_rows[iy] == TROW_FULL) {
+        expect_rows[expect_cleared++] = iy;
+      }
+    }
+    TEST_CHECK(ref_clear_full_rows(ref_grid) == expect_cleared);
+    uint8_t num_cleared = tetris_clear_full_rows(cleared_rows);
+    TEST_CHECK(num_cleared == expect_cleared);
+    TEST_CHECK(memcmp(cleared_rows, expect_rows, expect_cleared) == 0);
+    TEST_CHECK(memcmp(ref_grid, tetris_grid, sizeof(ref_grid)) == 0);
+    // The bitboard still matches the byte grid.
+    for (iy = 0; iy < 20; ++iy) {
+      uint16_t row = 0x0000;
+      for (ix = 0; ix < 10; ++ix) {
+        if (tetris_grid[ix][iy] != TGRID_EMPTY) { row |= (1 << ix); }
+      }
+      TEST_CHECK(tetris_rows[iy] == row);
+    }
+  }
+}
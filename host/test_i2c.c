@@ -0,0 +1,64 @@
+/*
+ * Check how display updates are split into I2C 'NBYTES' chunks.
+ * 'NBYTES' only holds up to 255, and the firmware reloads it at
+ * most 127 bytes at a time; each transfer's first chunk also
+ * carries the 'Data/Command' control byte.
+ */
+#include <string.h>
+
+#include "test.h"
+
+/*
+ * Send the dirty regions as one display update, and check the
+ * chunks that it was sent in and what ended up on the display.
+ */
+static void check_update(const uint8_t *chunks, uint16_t num_chunks) {
+  uint16_t i;
+  host_i2c_chunk_count = 0;
+  host_i2c_errors = 0;
+  ssd1306_update(I2C1);
+  host_run_i2c();
+  TEST_CHECK(host_i2c_errors == 0);
+  TEST_CHECK(oled_fb_dma_state == OLED_FB_DMA_IDLE);
+  TEST_CHECK(host_i2c_chunk_count == num_chunks);
+  for (i = 0; i < num_chunks && i < host_i2c_chunk_count; ++i) {
+    if (host_i2c_chunk_log[i] != chunks[i]) {
+      printf("chunk %u: sent %u bytes, expected %u\n",
+             i, host_i2c_chunk_log[i], chunks[i]);
+    }
+    TEST_CHECK(host_i2c_chunk_log[i] == chunks[i]);
+  }
+  TEST_CHECK(memcmp(host_gddram, oled_fb_front, OLED_FB_SIZE) == 0);
+}
+
+void test_i2c_chunks(void) {
+  uint16_t i;
+  for (i = 0; i < OLED_FB_SIZE; ++i) {
+    oled_fb_front[i] = (i * 7) + (i >> 8);
+  }
+  // A full frame: the addressing command, then 1025 bytes as
+  // 127 (the control byte and 126 from the buffer), 7x127, 9.
+  static const uint8_t full[] = {
+    7, 127, 127, 127, 127, 127, 127, 127, 127, 9
+  };
+  oled_mark_all_dirty();
+  check_update(full, sizeof(full));
+
+  // Partial windows on two pages are sent one page at a time.
+  static const uint8_t partial[] = { 7, 21, 7, 21 };
+  for (i = 10; i < 30; ++i) {
+    oled_fb_front[(2 * 128) + i] ^= 0xA5;
+    oled_fb_front[(3 * 128) + i] ^= 0xA5;
+  }
+  oled_mark_dirty(10, 16, 20, 16);
+  check_update(partial, sizeof(partial));
+
+  // Full-width pages are merged into one transfer; 257 bytes
+  // takes two reloads.
+  static const uint8_t merged[] = { 7, 127, 127, 3, 7, 2 };
+  for (i = 0; i < 256; ++i) { oled_fb_front[i] ^= 0x5A; }
+  oled_fb_front[OLED_FB_SIZE - 1] ^= 0x5A;
+  oled_mark_dirty(0, 0, 128, 16);
+  oled_mark_dirty(127, 63, 1, 1);
+  check_update(merged, sizeof(merged));
+}
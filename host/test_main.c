@@ -0,0 +1,35 @@
+/*
+ * Host-native test runner.
+ * Usage: tetris_test
+ * Runs every test, and prints how many checks failed.
+ */
+#include "test.h"
+
+uint32_t test_checks;
+uint32_t test_failures;
+
+typedef struct {
+  const char *name;
+  void (*run)(void);
+} test_def_t;
+
+static const test_def_t TESTS[] = {
+  { "i2c_chunks", test_i2c_chunks },
+  { "grid_collisions", test_grid_collisions },
+  { "grid_row_clears", test_grid_row_clears },
+  { "text_cache", test_text_cache },
+};
+
+int main(void) {
+  uint8_t i;
+  for (i = 0; i < (sizeof(TESTS) / sizeof(TESTS[0])); ++i) {
+    uint32_t failures = test_failures;
+    game_init();
+    TESTS[i].run();
+    printf("%-16s %s\n", TESTS[i].name,
+           (test_failures == failures) ? "ok" : "FAILED");
+  }
+  printf("%lu checks, %lu failed\n",
+         (unsigned long)test_checks, (unsigned long)test_failures);
+  return test_failures ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Check that text drawn through the text cache matches the same
+ * text drawn glyph by glyph, including where it is clipped by the
+ * edges of the screen.
+ */
+#include <string.h>
+
+#include "test.h"
+
+static unsigned char expected_fb[OLED_FB_SIZE];
+
+/*
+ * Draw a string both ways over the same pattern, and compare
+ * the framebuffers and the dirty regions.
+ */
+static void check_text(int x, int y, const char *cc, unsigned char color, char size) {
+  uint8_t dirty_x0[OLED_PAGES];
+  uint8_t dirty_x1[OLED_PAGES];
+  uint16_t i;
+  for (i = 0; i < OLED_FB_SIZE; ++i) {
+    oled_fb[i] = (i * 13) ^ (i >> 3);
+  }
+  oled_clear_dirty();
+  oled_draw_text(x, y, (char*)cc, color, size);
+  memcpy(expected_fb, oled_fb, OLED_FB_SIZE);
+  memcpy(dirty_x0, oled_dirty_x0, sizeof(dirty_x0));
+  memcpy(dirty_x1, oled_dirty_x1, sizeof(dirty_x1));
+  for (i = 0; i < OLED_FB_SIZE; ++i) {
+    oled_fb[i] = (i * 13) ^ (i >> 3);
+  }
+  oled_clear_dirty();
+  oled_draw_text_cached(x, y, cc, color, size);
+  if (memcmp(oled_fb, expected_fb, OLED_FB_SIZE) != 0) {
+    printf("'%s' (%c, color %u) at %d,%d: framebuffers differ\n",
+           cc, size, color, x, y);
+  }
+  TEST_CHECK(memcmp(oled_fb, expected_fb, OLED_FB_SIZE) == 0);
+  TEST_CHECK(memcmp(oled_dirty_x0, dirty_x0, sizeof(dirty_x0)) == 0);
+  TEST_CHECK(memcmp(oled_dirty_x1, dirty_x1, sizeof(dirty_x1)) == 0);
+}
+
+void test_text_cache(void) {
+  static const char *labels[] = { "TETRIS", "Start", "GAME", "OVER", "Hi" };
+  int x;
+  int y;
+  uint8_t i;
+  for (y = -18; y <= 66; y += 3) {
+    for (x = -80; x <= 130; x += 7) {
+      for (i = 0; i < (sizeof(labels) / sizeof(labels[0])); ++i) {
+        check_text(x, y, labels[i], (x + y) & 1, (i & 1) ? 'S' : 'L');
+      }
+    }
+  }
+  // A string which is too wide for the column pool is drawn
+  // without the cache.
+  check_text(-3, 20, "0123456789ABCDEFGHIJ", 1, 'L');
+  // A changed string is rasterised again once it is invalidated.
+  char buf[4] = "AB";
+  check_text(10, 10, buf, 1, 'S');
+  buf[0] = 'C';
+  oled_text_cache_invalidate(buf);
+  check_text(10, 10, buf, 1, 'S');
+}
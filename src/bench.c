@@ -0,0 +1,202 @@
+#include "bench.h"
+
+#ifdef VVC_HOST
+  #include <time.h>
+#endif
+
+/*
+ * Read the benchmark timer.
+ * On the chip, this is the SysTick system clock in core clock
+ * cycles, so 'clock_init' must be called first.
+ */
+uint32_t bench_now(void) {
+#ifdef VVC_HOST
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((ts.tv_sec * 1000000000ULL) + ts.tv_nsec);
+#else
+  return clock_cycles();
+#endif
+}
+
+/*
+ * Return the time between two 'bench_now' readings.
+ */
+uint32_t bench_elapsed(uint32_t start, uint32_t end) {
+  return end - start;
+}
+
+// Benchmark cases. Each one draws to the 'back' framebuffer.
+static void bench_empty(void) {
+}
+
+static void bench_h_line(void) {
+  oled_draw_h_line(0, 13, 128, 1);
+}
+
+static void bench_v_line(void) {
+  oled_draw_v_line(77, 0, 64, 1);
+}
+
+static void bench_rect_outline(void) {
+  oled_draw_rect(15, 0, 96, 64, 2, 1);
+}
+
+static void bench_rect_cell(void) {
+  oled_draw_rect(51, 30, 2, 2, 0, 1);
+}
+
+static void bench_rect_clear(void) {
+  oled_draw_rect(0, 0, 128, 64, 0, 0);
+}
+
+static void bench_fb_clear(void) {
+  fb_clear(oled_fb);
+}
+
+static void bench_fb_copy(void) {
+  fb_copy(oled_fb, oled_fb_front);
+}
+
+static void bench_letter_s(void) {
+  oled_draw_letter_c(40, 21, 'A', 1, 'S');
+}
+
+static void bench_letter_l(void) {
+  oled_draw_letter_c(40, 21, 'A', 1, 'L');
+}
+
+static void bench_text_s(void) {
+  oled_draw_text(50, 40, "Start\0", 1, 'S');
+}
+
+static void bench_text_l(void) {
+  oled_draw_text(27, 12, "TETRIS\0", 1, 'L');
+}
+
+static void bench_main_menu_full(void) {
+  // Force the menu to be redrawn.
+  oled_drawn_screen = OLED_SCREEN_NONE;
+  draw_main_menu();
+}
+
+static void bench_format_int(void) {
+  oled_format_int(oled_line_buf, 987654, 7, ' ');
+}
+
+static void bench_int_field(void) {
+  oled_draw_int_field(17, 40, 987654, 7, 1, 'S');
+}
+
+static void bench_text_font(void) {
+  oled_draw_text_font(27, 40, "Score 1234", &FONT_6X8, 1);
+}
+
+static void bench_text_font_2x(void) {
+  oled_draw_text_font(27, 12, "TETRIS", &FONT_6X8_2X, 1);
+}
+
+static void bench_text_cached_l(void) {
+  oled_draw_text_cached(27, 12, "TETRIS\0", 1, 'L');
+}
+
+static void bench_tetris_full(void) {
+  // Force the border and grid to be redrawn.
+  oled_drawn_screen = OLED_SCREEN_NONE;
+  draw_tetris_game();
+}
+
+static void bench_tetris_incr(void) {
+  // Move the brick back and forth, so that a few cells change.
+  cur_block_x = (cur_block_x == 3) ? 4 : 3;
+  draw_tetris_game();
+}
+
+typedef struct {
+  const char *name;
+  void (*run)(void);
+} bench_case_t;
+
+static const bench_case_t BENCH_CASES[] = {
+  { "empty",                 bench_empty },
+  { "oled_draw_h_line",      bench_h_line },
+  { "oled_draw_v_line",      bench_v_line },
+  { "oled_draw_rect_outline", bench_rect_outline },
+  { "oled_draw_rect_cell",   bench_rect_cell },
+  { "oled_draw_rect_clear",  bench_rect_clear },
+  { "fb_clear",              bench_fb_clear },
+  { "fb_copy",               bench_fb_copy },
+  { "oled_draw_letter_s",    bench_letter_s },
+  { "oled_draw_letter_l",    bench_letter_l },
+  { "oled_draw_text_s",      bench_text_s },
+  { "oled_draw_text_l",      bench_text_l },
+  { "oled_format_int",       bench_format_int },
+  { "oled_draw_int_field",   bench_int_field },
+  { "oled_draw_text_font",   bench_text_font },
+  { "oled_draw_text_font_2x", bench_text_font_2x },
+  { "oled_draw_text_cached_l", bench_text_cached_l },
+  { "draw_main_menu_full",   bench_main_menu_full },
+  { "draw_tetris_game_full", bench_tetris_full },
+  { "draw_tetris_game_incr", bench_tetris_incr },
+};
+#define BENCH_NUM_CASES (sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]))
+
+/*
+ * Fill the grid with a fixed pattern for the game benchmarks.
+ */
+static void bench_setup_grid(void) {
+  uint8_t grid_ix;
+  uint8_t grid_iy;
+  reset_game_state();
+  for (grid_iy = 10; grid_iy < 20; ++grid_iy) {
+    for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+      if ((grid_ix + grid_iy) % 3) {
+        tetris_grid[grid_ix][grid_iy] = TGRID_T;
+        tetris_rows[grid_iy] |= (1 << grid_ix);
+      }
+    }
+  }
+  cur_block_type = TBRICK_T;
+  cur_block_x = 3;
+  cur_block_y = 4;
+  cur_block_r = 0;
+}
+
+/*
+ * Run each benchmark case 'iterations' times, timing each call.
+ * The results are stored in 'bench_results'. This leaves the
+ * framebuffer and game state scrambled, so the game should be
+ * reset afterwards.
+ * Returns the number of results.
+ */
+uint8_t bench_run_all(uint16_t iterations) {
+  uint8_t case_i;
+  uint16_t iter;
+  uint32_t start;
+  uint32_t elapsed;
+  uint32_t overhead = 0;
+  bench_setup_grid();
+  for (case_i = 0; case_i < BENCH_NUM_CASES && case_i < BENCH_MAX_CASES; ++case_i) {
+    bench_result_t *res = &bench_results[case_i];
+    res->name = BENCH_CASES[case_i].name;
+    res->iterations = iterations;
+    res->min = 0xFFFFFFFF;
+    res->max = 0;
+    res->total = 0;
+    for (iter = 0; iter < iterations; ++iter) {
+      start = bench_now();
+      BENCH_CASES[case_i].run();
+      elapsed = bench_elapsed(start, bench_now());
+      elapsed = (elapsed > overhead) ? (elapsed - overhead) : 0;
+      if (elapsed < res->min) { res->min = elapsed; }
+      if (elapsed > res->max) { res->max = elapsed; }
+      res->total += elapsed;
+    }
+    if (case_i == 0) {
+      // The 'empty' case measures the timer overhead.
+      overhead = res->min;
+    }
+  }
+  bench_num_results = case_i;
+  return case_i;
+}
@@ -0,0 +1,36 @@
+#ifndef _VVC_BENCH_H
+#define _VVC_BENCH_H
+
+#include "global.h"
+#include "util_c.h"
+
+// Benchmark harness for the rendering primitives.
+// On the chip, the SysTick system clock counts core clock
+// cycles; on the host, 'clock_gettime' counts nanoseconds.
+#ifdef VVC_HOST
+  #define BENCH_UNITS "ns"
+#else
+  #define BENCH_UNITS "cycles"
+#endif
+#define BENCH_MAX_CASES (24)
+
+// Timing results for one benchmark case. The timer overhead
+// (measured with an empty case) is subtracted from each call.
+typedef struct {
+  const char *name;
+  uint32_t iterations;
+  uint32_t min;
+  uint32_t max;
+  uint32_t total;
+} bench_result_t;
+
+// The results of the last 'bench_run_all' call, so that
+// a debugger can read them on the chip.
+bench_result_t bench_results[BENCH_MAX_CASES];
+uint8_t bench_num_results;
+
+uint32_t bench_now(void);
+uint32_t bench_elapsed(uint32_t start, uint32_t end);
+uint8_t bench_run_all(uint16_t iterations);
+
+#endif
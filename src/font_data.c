@@ -0,0 +1,388 @@
+/*
+ * Font data generated by tools/bdf2font.py; do not edit.
+ * Regenerate it with 'make fonts'.
+ */
+#include "global.h"
+
+// FONT_6X8: vvc6x8.bdf, 1x, 8px tall, 348 bytes of column data.
+static const uint8_t FONT_6X8_DATA[] = {
+  0x5E, 0x24, 0x7E, 0x24, 0x7E, 0x24, 0xC3, 0x23, 0x18, 0xC4, 0xC3, 0x03,
+  0x3C, 0x42, 0x81, 0x81, 0x42, 0x3C, 0x14, 0x08, 0x3E, 0x08, 0x14, 0x10,
+  0x38, 0x10, 0x80, 0x60, 0x10, 0x10, 0x10, 0x40, 0x60, 0x18, 0x06, 0x7E,
+  0x87, 0x99, 0xE1, 0x7E, 0x84, 0x82, 0xFF, 0x80, 0x80, 0xC6, 0xE1, 0xB1,
+  0x99, 0x8E, 0x66, 0x81, 0x91, 0x91, 0x6E, 0x1F, 0x10, 0x10, 0xFF, 0x10,
+  0x47, 0x89, 0x89, 0x89, 0x71, 0x7E, 0x89, 0x89, 0x89, 0x72, 0x06, 0xC1,
+  0x31, 0x0D, 0x03, 0x76, 0x89, 0x89, 0x89, 0x76, 0x4E, 0x91, 0x91, 0x91,
+  0x7E, 0x24, 0x10, 0x28, 0x44, 0x28, 0x28, 0x28, 0x22, 0x14, 0x08, 0x02,
+  0x01, 0xB1, 0x09, 0x06, 0xF8, 0x16, 0x11, 0x16, 0xF8, 0xFF, 0x91, 0x91,
+  0x91, 0x6E, 0x7E, 0x81, 0x81, 0x81, 0x66, 0xFF, 0x81, 0x81, 0x81, 0x7E,
+  0xFF, 0x91, 0x91, 0x91, 0x81, 0xFF, 0x11, 0x11, 0x11, 0x01, 0x7E, 0x81,
+  0x91, 0x91, 0x76, 0xFF, 0x10, 0x10, 0x10, 0xFF, 0x81, 0x81, 0xFF, 0x81,
+  0x81, 0x61, 0x81, 0x81, 0x7F, 0x01, 0xFF, 0x18, 0x24, 0x42, 0x81, 0xFF,
+  0x80, 0x80, 0x80, 0x80, 0xFF, 0x02, 0x0C, 0x02, 0xFF, 0xFF, 0x06, 0x18,
+  0x60, 0xFF, 0x7E, 0x81, 0x81, 0x81, 0x7E, 0xFF, 0x11, 0x11, 0x11, 0x0E,
+  0x7E, 0x81, 0xA1, 0x41, 0xBE, 0xFF, 0x11, 0x31, 0x51, 0x8E, 0x66, 0x89,
+  0x99, 0x91, 0x66, 0x01, 0x01, 0xFF, 0x01, 0x01, 0x7F, 0x80, 0x80, 0x80,
+  0x7F, 0x0E, 0x38, 0xC0, 0x38, 0x07, 0x7F, 0x80, 0x60, 0x80, 0x7F, 0xC3,
+  0x24, 0x18, 0x24, 0xC3, 0x07, 0x08, 0xF0, 0x08, 0x07, 0xC1, 0xA1, 0x99,
+  0x85, 0x83, 0x80, 0x80, 0x80, 0x80, 0x80, 0x60, 0x94, 0x94, 0x94, 0xF8,
+  0xFF, 0x90, 0x90, 0x90, 0x60, 0x78, 0x84, 0x84, 0x84, 0x48, 0x60, 0x90,
+  0x90, 0xFF, 0x80, 0x7C, 0x92, 0x92, 0x92, 0x5C, 0x10, 0xFE, 0x11, 0x11,
+  0x06, 0x4C, 0x92, 0x92, 0x92, 0x7C, 0xFF, 0x10, 0x10, 0x10, 0xE0, 0xF2,
+  0x60, 0x80, 0x7A, 0xFF, 0x38, 0xC4, 0xFF, 0xFC, 0x08, 0xF8, 0x08, 0xF0,
+  0xFC, 0x08, 0x08, 0xF0, 0x70, 0x88, 0x88, 0x88, 0x70, 0xFC, 0x24, 0x24,
+  0x18, 0x0C, 0x12, 0x12, 0x7E, 0x80, 0xFC, 0x08, 0x08, 0x10, 0x4C, 0x92,
+  0x92, 0x64, 0x04, 0x7F, 0x84, 0x84, 0x40, 0x3C, 0x40, 0x40, 0x7C, 0xC0,
+  0x18, 0x60, 0x80, 0x60, 0x18, 0x78, 0x80, 0x40, 0x80, 0x78, 0x88, 0x50,
+  0x20, 0x50, 0x88, 0x4C, 0x90, 0x90, 0x7C, 0x88, 0xC8, 0xA8, 0x98, 0x88,
+};
+static const font_glyph_t FONT_6X8_GLYPHS[] = {
+  {    0,  0,  3 }, // ' '
+  {    0,  1,  2 }, // '!'
+  {    1,  0,  3 }, // '"'
+  {    1,  5,  6 }, // '#'
+  {    6,  0,  3 }, // '$'
+  {    6,  5,  6 }, // '%'
+  {   11,  0,  3 }, // '&'
+  {   11,  1,  2 }, // '\''
+  {   12,  3,  4 }, // '('
+  {   15,  3,  4 }, // ')'
+  {   18,  5,  6 }, // '*'
+  {   23,  3,  4 }, // '+'
+  {   26,  2,  3 }, // ','
+  {   28,  3,  4 }, // '-'
+  {   31,  1,  2 }, // '.'
+  {   32,  3,  4 }, // '/'
+  {   35,  5,  6 }, // '0'
+  {   40,  5,  6 }, // '1'
+  {   45,  5,  6 }, // '2'
+  {   50,  5,  6 }, // '3'
+  {   55,  5,  6 }, // '4'
+  {   60,  5,  6 }, // '5'
+  {   65,  5,  6 }, // '6'
+  {   70,  5,  6 }, // '7'
+  {   75,  5,  6 }, // '8'
+  {   80,  5,  6 }, // '9'
+  {   85,  1,  2 }, // ':'
+  {   86,  0,  3 }, // ';'
+  {   86,  3,  4 }, // '<'
+  {   89,  3,  4 }, // '='
+  {   92,  3,  4 }, // '>'
+  {   95,  5,  6 }, // '?'
+  {  100,  0,  3 }, // '@'
+  {  100,  5,  6 }, // 'A'
+  {  105,  5,  6 }, // 'B'
+  {  110,  5,  6 }, // 'C'
+  {  115,  5,  6 }, // 'D'
+  {  120,  5,  6 }, // 'E'
+  {  125,  5,  6 }, // 'F'
+  {  130,  5,  6 }, // 'G'
+  {  135,  5,  6 }, // 'H'
+  {  140,  5,  6 }, // 'I'
+  {  145,  5,  6 }, // 'J'
+  {  150,  5,  6 }, // 'K'
+  {  155,  5,  6 }, // 'L'
+  {  160,  5,  6 }, // 'M'
+  {  165,  5,  6 }, // 'N'
+  {  170,  5,  6 }, // 'O'
+  {  175,  5,  6 }, // 'P'
+  {  180,  5,  6 }, // 'Q'
+  {  185,  5,  6 }, // 'R'
+  {  190,  5,  6 }, // 'S'
+  {  195,  5,  6 }, // 'T'
+  {  200,  5,  6 }, // 'U'
+  {  205,  5,  6 }, // 'V'
+  {  210,  5,  6 }, // 'W'
+  {  215,  5,  6 }, // 'X'
+  {  220,  5,  6 }, // 'Y'
+  {  225,  5,  6 }, // 'Z'
+  {  230,  0,  3 }, // '['
+  {  230,  0,  3 }, // '\\'
+  {  230,  0,  3 }, // ']'
+  {  230,  0,  3 }, // '^'
+  {  230,  5,  6 }, // '_'
+  {  235,  0,  3 }, // '`'
+  {  235,  5,  6 }, // 'a'
+  {  240,  5,  6 }, // 'b'
+  {  245,  5,  6 }, // 'c'
+  {  250,  5,  6 }, // 'd'
+  {  255,  5,  6 }, // 'e'
+  {  260,  5,  6 }, // 'f'
+  {  265,  5,  6 }, // 'g'
+  {  270,  5,  6 }, // 'h'
+  {  275,  1,  2 }, // 'i'
+  {  276,  3,  4 }, // 'j'
+  {  279,  3,  4 }, // 'k'
+  {  282,  1,  2 }, // 'l'
+  {  283,  5,  6 }, // 'm'
+  {  288,  4,  5 }, // 'n'
+  {  292,  5,  6 }, // 'o'
+  {  297,  4,  5 }, // 'p'
+  {  301,  5,  6 }, // 'q'
+  {  306,  4,  5 }, // 'r'
+  {  310,  4,  5 }, // 's'
+  {  314,  5,  6 }, // 't'
+  {  319,  5,  6 }, // 'u'
+  {  324,  5,  6 }, // 'v'
+  {  329,  5,  6 }, // 'w'
+  {  334,  5,  6 }, // 'x'
+  {  339,  4,  5 }, // 'y'
+  {  343,  5,  6 }, // 'z'
+};
+const font_t FONT_6X8 = {
+  8, 0x20, 0x7A, FONT_6X8_GLYPHS, FONT_6X8_DATA
+};
+
+// FONT_6X8_2X: vvc6x8.bdf, 2x, 16px tall, 1392 bytes of column data.
+static const uint8_t FONT_6X8_2X_DATA[] = {
+  0xFC, 0x33, 0xFC, 0x33, 0x30, 0x0C, 0x30, 0x0C, 0xFC, 0x3F, 0xFC, 0x3F,
+  0x30, 0x0C, 0x30, 0x0C, 0xFC, 0x3F, 0xFC, 0x3F, 0x30, 0x0C, 0x30, 0x0C,
+  0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0x0C, 0x0F, 0x0C, 0xC0, 0x03, 0xC0, 0x03,
+  0x30, 0xF0, 0x30, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0x00, 0x0F, 0x00,
+  0xF0, 0x0F, 0xF0, 0x0F, 0x0C, 0x30, 0x0C, 0x30, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC0, 0x03, 0xC0, 0x0C, 0x30, 0x0C, 0x30, 0xF0, 0x0F, 0xF0, 0x0F,
+  0x30, 0x03, 0x30, 0x03, 0xC0, 0x00, 0xC0, 0x00, 0xFC, 0x0F, 0xFC, 0x0F,
+  0xC0, 0x00, 0xC0, 0x00, 0x30, 0x03, 0x30, 0x03, 0x00, 0x03, 0x00, 0x03,
+  0xC0, 0x0F, 0xC0, 0x0F, 0x00, 0x03, 0x00, 0x03, 0x00, 0xC0, 0x00, 0xC0,
+  0x00, 0x3C, 0x00, 0x3C, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03,
+  0x00, 0x03, 0x00, 0x03, 0x00, 0x30, 0x00, 0x30, 0x00, 0x3C, 0x00, 0x3C,
+  0xC0, 0x03, 0xC0, 0x03, 0x3C, 0x00, 0x3C, 0x00, 0xFC, 0x3F, 0xFC, 0x3F,
+  0x3F, 0xC0, 0x3F, 0xC0, 0xC3, 0xC3, 0xC3, 0xC3, 0x03, 0xFC, 0x03, 0xFC,
+  0xFC, 0x3F, 0xFC, 0x3F, 0x30, 0xC0, 0x30, 0xC0, 0x0C, 0xC0, 0x0C, 0xC0,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0,
+  0x3C, 0xF0, 0x3C, 0xF0, 0x03, 0xFC, 0x03, 0xFC, 0x03, 0xCF, 0x03, 0xCF,
+  0xC3, 0xC3, 0xC3, 0xC3, 0xFC, 0xC0, 0xFC, 0xC0, 0x3C, 0x3C, 0x3C, 0x3C,
+  0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3,
+  0xFC, 0x3C, 0xFC, 0x3C, 0xFF, 0x03, 0xFF, 0x03, 0x00, 0x03, 0x00, 0x03,
+  0x00, 0x03, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x03, 0x00, 0x03,
+  0x3F, 0x30, 0x3F, 0x30, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0,
+  0xC3, 0xC0, 0xC3, 0xC0, 0x03, 0x3F, 0x03, 0x3F, 0xFC, 0x3F, 0xFC, 0x3F,
+  0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0,
+  0x0C, 0x3F, 0x0C, 0x3F, 0x3C, 0x00, 0x3C, 0x00, 0x03, 0xF0, 0x03, 0xF0,
+  0x03, 0x0F, 0x03, 0x0F, 0xF3, 0x00, 0xF3, 0x00, 0x0F, 0x00, 0x0F, 0x00,
+  0x3C, 0x3F, 0x3C, 0x3F, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0,
+  0xC3, 0xC0, 0xC3, 0xC0, 0x3C, 0x3F, 0x3C, 0x3F, 0xFC, 0x30, 0xFC, 0x30,
+  0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3,
+  0xFC, 0x3F, 0xFC, 0x3F, 0x30, 0x0C, 0x30, 0x0C, 0x00, 0x03, 0x00, 0x03,
+  0xC0, 0x0C, 0xC0, 0x0C, 0x30, 0x30, 0x30, 0x30, 0xC0, 0x0C, 0xC0, 0x0C,
+  0xC0, 0x0C, 0xC0, 0x0C, 0xC0, 0x0C, 0xC0, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C,
+  0x30, 0x03, 0x30, 0x03, 0xC0, 0x00, 0xC0, 0x00, 0x0C, 0x00, 0x0C, 0x00,
+  0x03, 0x00, 0x03, 0x00, 0x03, 0xCF, 0x03, 0xCF, 0xC3, 0x00, 0xC3, 0x00,
+  0x3C, 0x00, 0x3C, 0x00, 0xC0, 0xFF, 0xC0, 0xFF, 0x3C, 0x03, 0x3C, 0x03,
+  0x03, 0x03, 0x03, 0x03, 0x3C, 0x03, 0x3C, 0x03, 0xC0, 0xFF, 0xC0, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3,
+  0x03, 0xC3, 0x03, 0xC3, 0xFC, 0x3C, 0xFC, 0x3C, 0xFC, 0x3F, 0xFC, 0x3F,
+  0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0,
+  0x3C, 0x3C, 0x3C, 0x3C, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0xFC, 0x3F, 0xFC, 0x3F,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3,
+  0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC0, 0x03, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+  0x03, 0x00, 0x03, 0x00, 0xFC, 0x3F, 0xFC, 0x3F, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x3C, 0x3F, 0x3C, 0x3F,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03,
+  0x00, 0x03, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC0, 0x03, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC0, 0x03, 0xC0, 0x03, 0x3C, 0x03, 0x3C, 0x03, 0xC0, 0x03, 0xC0,
+  0x03, 0xC0, 0x03, 0xC0, 0xFF, 0x3F, 0xFF, 0x3F, 0x03, 0x00, 0x03, 0x00,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x03, 0xC0, 0x03, 0x30, 0x0C, 0x30, 0x0C,
+  0x0C, 0x30, 0x0C, 0x30, 0x03, 0xC0, 0x03, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0,
+  0x00, 0xC0, 0x00, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0x0C, 0x00, 0x0C, 0x00,
+  0xF0, 0x00, 0xF0, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x3C, 0x00, 0x3C, 0x00, 0xC0, 0x03, 0xC0, 0x03,
+  0x00, 0x3C, 0x00, 0x3C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0x3F, 0xFC, 0x3F,
+  0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0,
+  0xFC, 0x3F, 0xFC, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03,
+  0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xFC, 0x00, 0xFC, 0x00,
+  0xFC, 0x3F, 0xFC, 0x3F, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xCC, 0x03, 0xCC,
+  0x03, 0x30, 0x03, 0x30, 0xFC, 0xCF, 0xFC, 0xCF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x03, 0x03, 0x03, 0x03, 0x03, 0x0F, 0x03, 0x0F, 0x03, 0x33, 0x03, 0x33,
+  0xFC, 0xC0, 0xFC, 0xC0, 0x3C, 0x3C, 0x3C, 0x3C, 0xC3, 0xC0, 0xC3, 0xC0,
+  0xC3, 0xC3, 0xC3, 0xC3, 0x03, 0xC3, 0x03, 0xC3, 0x3C, 0x3C, 0x3C, 0x3C,
+  0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0xFF, 0x3F, 0xFF, 0x3F,
+  0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0,
+  0xFF, 0x3F, 0xFF, 0x3F, 0xFC, 0x00, 0xFC, 0x00, 0xC0, 0x0F, 0xC0, 0x0F,
+  0x00, 0xF0, 0x00, 0xF0, 0xC0, 0x0F, 0xC0, 0x0F, 0x3F, 0x00, 0x3F, 0x00,
+  0xFF, 0x3F, 0xFF, 0x3F, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0x3C, 0x00, 0x3C,
+  0x00, 0xC0, 0x00, 0xC0, 0xFF, 0x3F, 0xFF, 0x3F, 0x0F, 0xF0, 0x0F, 0xF0,
+  0x30, 0x0C, 0x30, 0x0C, 0xC0, 0x03, 0xC0, 0x03, 0x30, 0x0C, 0x30, 0x0C,
+  0x0F, 0xF0, 0x0F, 0xF0, 0x3F, 0x00, 0x3F, 0x00, 0xC0, 0x00, 0xC0, 0x00,
+  0x00, 0xFF, 0x00, 0xFF, 0xC0, 0x00, 0xC0, 0x00, 0x3F, 0x00, 0x3F, 0x00,
+  0x03, 0xF0, 0x03, 0xF0, 0x03, 0xCC, 0x03, 0xCC, 0xC3, 0xC3, 0xC3, 0xC3,
+  0x33, 0xC0, 0x33, 0xC0, 0x0F, 0xC0, 0x0F, 0xC0, 0x00, 0xC0, 0x00, 0xC0,
+  0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0,
+  0x00, 0xC0, 0x00, 0xC0, 0x00, 0x3C, 0x00, 0x3C, 0x30, 0xC3, 0x30, 0xC3,
+  0x30, 0xC3, 0x30, 0xC3, 0x30, 0xC3, 0x30, 0xC3, 0xC0, 0xFF, 0xC0, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xC3,
+  0x00, 0xC3, 0x00, 0xC3, 0x00, 0x3C, 0x00, 0x3C, 0xC0, 0x3F, 0xC0, 0x3F,
+  0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0,
+  0xC0, 0x30, 0xC0, 0x30, 0x00, 0x3C, 0x00, 0x3C, 0x00, 0xC3, 0x00, 0xC3,
+  0x00, 0xC3, 0x00, 0xC3, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xC0, 0x00, 0xC0,
+  0xF0, 0x3F, 0xF0, 0x3F, 0x0C, 0xC3, 0x0C, 0xC3, 0x0C, 0xC3, 0x0C, 0xC3,
+  0x0C, 0xC3, 0x0C, 0xC3, 0xF0, 0x33, 0xF0, 0x33, 0x00, 0x03, 0x00, 0x03,
+  0xFC, 0xFF, 0xFC, 0xFF, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+  0x3C, 0x00, 0x3C, 0x00, 0xF0, 0x30, 0xF0, 0x30, 0x0C, 0xC3, 0x0C, 0xC3,
+  0x0C, 0xC3, 0x0C, 0xC3, 0x0C, 0xC3, 0x0C, 0xC3, 0xF0, 0x3F, 0xF0, 0x3F,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03,
+  0x00, 0x03, 0x00, 0x03, 0x00, 0xFC, 0x00, 0xFC, 0x0C, 0xFF, 0x0C, 0xFF,
+  0x00, 0x3C, 0x00, 0x3C, 0x00, 0xC0, 0x00, 0xC0, 0xCC, 0x3F, 0xCC, 0x3F,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x0F, 0xC0, 0x0F, 0x30, 0xF0, 0x30, 0xF0,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xF0, 0xFF, 0xF0, 0xFF, 0xC0, 0x00, 0xC0, 0x00,
+  0xC0, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0xC0, 0x00, 0x00, 0xFF, 0x00, 0xFF,
+  0xF0, 0xFF, 0xF0, 0xFF, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00,
+  0x00, 0xFF, 0x00, 0xFF, 0x00, 0x3F, 0x00, 0x3F, 0xC0, 0xC0, 0xC0, 0xC0,
+  0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0x3F, 0x00, 0x3F,
+  0xF0, 0xFF, 0xF0, 0xFF, 0x30, 0x0C, 0x30, 0x0C, 0x30, 0x0C, 0x30, 0x0C,
+  0xC0, 0x03, 0xC0, 0x03, 0xF0, 0x00, 0xF0, 0x00, 0x0C, 0x03, 0x0C, 0x03,
+  0x0C, 0x03, 0x0C, 0x03, 0xFC, 0x3F, 0xFC, 0x3F, 0x00, 0xC0, 0x00, 0xC0,
+  0xF0, 0xFF, 0xF0, 0xFF, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00,
+  0x00, 0x03, 0x00, 0x03, 0xF0, 0x30, 0xF0, 0x30, 0x0C, 0xC3, 0x0C, 0xC3,
+  0x0C, 0xC3, 0x0C, 0xC3, 0x30, 0x3C, 0x30, 0x3C, 0x30, 0x00, 0x30, 0x00,
+  0xFF, 0x3F, 0xFF, 0x3F, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0,
+  0x00, 0x30, 0x00, 0x30, 0xF0, 0x0F, 0xF0, 0x0F, 0x00, 0x30, 0x00, 0x30,
+  0x00, 0x30, 0x00, 0x30, 0xF0, 0x3F, 0xF0, 0x3F, 0x00, 0xF0, 0x00, 0xF0,
+  0xC0, 0x03, 0xC0, 0x03, 0x00, 0x3C, 0x00, 0x3C, 0x00, 0xC0, 0x00, 0xC0,
+  0x00, 0x3C, 0x00, 0x3C, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x3F, 0xC0, 0x3F,
+  0x00, 0xC0, 0x00, 0xC0, 0x00, 0x30, 0x00, 0x30, 0x00, 0xC0, 0x00, 0xC0,
+  0xC0, 0x3F, 0xC0, 0x3F, 0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0x33, 0x00, 0x33,
+  0x00, 0x0C, 0x00, 0x0C, 0x00, 0x33, 0x00, 0x33, 0xC0, 0xC0, 0xC0, 0xC0,
+  0xF0, 0x30, 0xF0, 0x30, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xC3,
+  0xF0, 0x3F, 0xF0, 0x3F, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xF0, 0xC0, 0xF0,
+  0xC0, 0xCC, 0xC0, 0xCC, 0xC0, 0xC3, 0xC0, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0,
+};
+static const font_glyph_t FONT_6X8_2X_GLYPHS[] = {
+  {    0,  0,  6 }, // ' '
+  {    0,  2,  4 }, // '!'
+  {    4,  0,  6 }, // '"'
+  {    4, 10, 12 }, // '#'
+  {   24,  0,  6 }, // '$'
+  {   24, 10, 12 }, // '%'
+  {   44,  0,  6 }, // '&'
+  {   44,  2,  4 }, // '\''
+  {   48,  6,  8 }, // '('
+  {   60,  6,  8 }, // ')'
+  {   72, 10, 12 }, // '*'
+  {   92,  6,  8 }, // '+'
+  {  104,  4,  6 }, // ','
+  {  112,  6,  8 }, // '-'
+  {  124,  2,  4 }, // '.'
+  {  128,  6,  8 }, // '/'
+  {  140, 10, 12 }, // '0'
+  {  160, 10, 12 }, // '1'
+  {  180, 10, 12 }, // '2'
+  {  200, 10, 12 }, // '3'
+  {  220, 10, 12 }, // '4'
+  {  240, 10, 12 }, // '5'
+  {  260, 10, 12 }, // '6'
+  {  280, 10, 12 }, // '7'
+  {  300, 10, 12 }, // '8'
+  {  320, 10, 12 }, // '9'
+  {  340,  2,  4 }, // ':'
+  {  344,  0,  6 }, // ';'
+  {  344,  6,  8 }, // '<'
+  {  356,  6,  8 }, // '='
+  {  368,  6,  8 }, // '>'
+  {  380, 10, 12 }, // '?'
+  {  400,  0,  6 }, // '@'
+  {  400, 10, 12 }, // 'A'
+  {  420, 10, 12 }, // 'B'
+  {  440, 10, 12 }, // 'C'
+  {  460, 10, 12 }, // 'D'
+  {  480, 10, 12 }, // 'E'
+  {  500, 10, 12 }, // 'F'
+  {  520, 10, 12 }, // 'G'
+  {  540, 10, 12 }, // 'H'
+  {  560, 10, 12 }, // 'I'
+  {  580, 10, 12 }, // 'J'
+  {  600, 10, 12 }, // 'K'
+  {  620, 10, 12 }, // 'L'
+  {  640, 10, 12 }, // 'M'
+  {  660, 10, 12 }, // 'N'
+  {  680, 10, 12 }, // 'O'
+  {  700, 10, 12 }, // 'P'
+  {  720, 10, 12 }, // 'Q'
+  {  740, 10, 12 }, // 'R'
+  {  760, 10, 12 }, // 'S'
+  {  780, 10, 12 }, // 'T'
+  {  800, 10, 12 }, // 'U'
+  {  820, 10, 12 }, // 'V'
+  {  840, 10, 12 }, // 'W'
+  {  860, 10, 12 }, // 'X'
+  {  880, 10, 12 }, // 'Y'
+  {  900, 10, 12 }, // 'Z'
+  {  920,  0,  6 }, // '['
+  {  920,  0,  6 }, // '\\'
+  {  920,  0,  6 }, // ']'
+  {  920,  0,  6 }, // '^'
+  {  920, 10, 12 }, // '_'
+  {  940,  0,  6 }, // '`'
+  {  940, 10, 12 }, // 'a'
+  {  960, 10, 12 }, // 'b'
+  {  980, 10, 12 }, // 'c'
+  { 1000, 10, 12 }, // 'd'
+  { 1020, 10, 12 }, // 'e'
+  { 1040, 10, 12 }, // 'f'
+  { 1060, 10, 12 }, // 'g'
+  { 1080, 10, 12 }, // 'h'
+  { 1100,  2,  4 }, // 'i'
+  { 1104,  6,  8 }, // 'j'
+  { 1116,  6,  8 }, // 'k'
+  { 1128,  2,  4 }, // 'l'
+  { 1132, 10, 12 }, // 'm'
+  { 1152,  8, 10 }, // 'n'
+  { 1168, 10, 12 }, // 'o'
+  { 1188,  8, 10 }, // 'p'
+  { 1204, 10, 12 }, // 'q'
+  { 1224,  8, 10 }, // 'r'
+  { 1240,  8, 10 }, // 's'
+  { 1256, 10, 12 }, // 't'
+  { 1276, 10, 12 }, // 'u'
+  { 1296, 10, 12 }, // 'v'
+  { 1316, 10, 12 }, // 'w'
+  { 1336, 10, 12 }, // 'x'
+  { 1356,  8, 10 }, // 'y'
+  { 1372, 10, 12 }, // 'z'
+};
+const font_t FONT_6X8_2X = {
+  16, 0x20, 0x7A, FONT_6X8_2X_GLYPHS, FONT_6X8_2X_DATA
+};
+
+// FONT_3X5: vvc3x5.bdf, 1x, 6px tall, 33 bytes of column data.
+static const uint8_t FONT_3X5_DATA[] = {
+  0x04, 0x04, 0x04, 0x1F, 0x11, 0x1F, 0x12, 0x1F, 0x10, 0x1D, 0x15, 0x17,
+  0x11, 0x15, 0x1F, 0x07, 0x04, 0x1F, 0x17, 0x15, 0x1D, 0x1F, 0x15, 0x1D,
+  0x01, 0x19, 0x07, 0x1F, 0x15, 0x1F, 0x17, 0x15, 0x1F,
+};
+static const font_glyph_t FONT_3X5_GLYPHS[] = {
+  {    0,  0,  4 }, // ' '
+  {    0,  0,  4 }, // '!'
+  {    0,  0,  4 }, // '"'
+  {    0,  0,  4 }, // '#'
+  {    0,  0,  4 }, // '$'
+  {    0,  0,  4 }, // '%'
+  {    0,  0,  4 }, // '&'
+  {    0,  0,  4 }, // '\''
+  {    0,  0,  4 }, // '('
+  {    0,  0,  4 }, // ')'
+  {    0,  0,  4 }, // '*'
+  {    0,  0,  4 }, // '+'
+  {    0,  0,  4 }, // ','
+  {    0,  3,  4 }, // '-'
+  {    3,  0,  4 }, // '.'
+  {    3,  0,  4 }, // '/'
+  {    3,  3,  4 }, // '0'
+  {    6,  3,  4 }, // '1'
+  {    9,  3,  4 }, // '2'
+  {   12,  3,  4 }, // '3'
+  {   15,  3,  4 }, // '4'
+  {   18,  3,  4 }, // '5'
+  {   21,  3,  4 }, // '6'
+  {   24,  3,  4 }, // '7'
+  {   27,  3,  4 }, // '8'
+  {   30,  3,  4 }, // '9'
+};
+const font_t FONT_3X5 = {
+  6, 0x20, 0x39, FONT_3X5_GLYPHS, FONT_3X5_DATA
+};
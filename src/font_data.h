@@ -0,0 +1,15 @@
+/*
+ * Font data generated by tools/bdf2font.py; do not edit.
+ * Regenerate it with 'make fonts'.
+ */
+#ifndef _VVC_FONT_DATA_H
+#define _VVC_FONT_DATA_H
+
+// FONT_6X8: vvc6x8.bdf, 1x, 8px tall.
+extern const font_t FONT_6X8;
+// FONT_6X8_2X: vvc6x8.bdf, 2x, 16px tall.
+extern const font_t FONT_6X8_2X;
+// FONT_3X5: vvc3x5.bdf, 1x, 6px tall.
+extern const font_t FONT_3X5;
+
+#endif
@@ -9,6 +9,10 @@
 #elif VVC_F3
   #include "stm32f3xx.h"
 #endif
+// Host-native builds replace the peripherals with stubs in RAM.
+#ifdef VVC_HOST
+  #include "host_periph.h"
+#endif
 
 // Assembly methods.
 extern void i2c_periph_init(unsigned int i2c_addr, unsigned int i2c_speed);
@@ -25,14 +29,97 @@ extern void pulse_out_pin(volatile void* gpiox_odr,
 
 // ----------------------
 // Global variables and defines.
-volatile unsigned char uled_state;
+unsigned char uled_state;
 #define GAME_STATE_MAIN_MENU  (0)
 #define GAME_STATE_IN_GAME    (1)
 #define GAME_STATE_PAUSED     (2)
 #define GAME_STATE_GAME_OVER  (3)
-volatile uint8_t game_state;
+uint8_t game_state;
 #define MAIN_MENU_STATE_START (0)
-volatile uint8_t main_menu_state;
+uint8_t main_menu_state;
+// The game state above and below is only changed by the main
+// loop, when it applies queued events between frames (see
+// 'game_process_events'), so none of it needs to be volatile
+// and the renderer always sees a consistent snapshot of it.
+// 'game_state_seq' counts the applied events, so the renderer
+// can tell when nothing has changed since the last frame.
+uint16_t game_state_seq;
+uint16_t drawn_state_seq;
+
+// Stop the compiler from moving memory accesses across this
+// point; used to publish data to/from interrupt handlers.
+#define COMPILER_BARRIER() __asm__ volatile ("" ::: "memory")
+
+// Event queue from the input and game clock tasks to the
+// renderer. The producers only record what happened; the
+// 'render' task applies the events to the game state between
+// frames, so the game is never changed while a frame is being
+// drawn. This is a ring with one writer and one reader at a
+// time: the 'input' and 'game' tasks push events, and the
+// 'render' task pops them. All three run to completion in the
+// main loop, so they never interrupt each other, and the queue
+// needs no 'volatile' or barriers; they would be needed again
+// if an interrupt handler ever pushed events.
+#define EVENT_NONE        (0)
+#define EVENT_PRESS_LEFT  (1)
+#define EVENT_PRESS_UP    (2)
+#define EVENT_PRESS_DOWN  (3)
+#define EVENT_PRESS_RIGHT (4)
+#define EVENT_PRESS_B     (5)
+#define EVENT_PRESS_A     (6)
+#define EVENT_GAME_FRAME  (7)
+typedef struct {
+  uint8_t type;
+  // The debounced buttons which were held down at the time.
+  uint8_t held;
+  // When the event happened, from 'clock_us'. For a press,
+  // this is when the first sample saw the button pressed,
+  // before it was debounced.
+  uint32_t time;
+} game_event_t;
+// (Must be a power of 2.)
+#define EVENT_QUEUE_LEN   (32)
+game_event_t event_queue[EVENT_QUEUE_LEN];
+// 'head' is only written by the 'input' and 'game' tasks, and
+// 'tail' only by the 'render' task. The queue is empty when
+// they are equal.
+uint8_t event_queue_head;
+uint8_t event_queue_tail;
+// Count of events dropped because the queue was full.
+uint16_t event_queue_dropped;
+// Frames counted by the 60Hz game clock.
+uint32_t game_frame_count;
+
+// The system clock. SysTick interrupts every 1ms (48000 core
+// clock cycles @48MHz) to count milliseconds, and the rest of
+// the time is read from its counter (see 'clock_us').
+#define SYSTICK_CYCLES_PER_MS (48000)
+volatile uint32_t clock_ms;
+
+// Button inputs. The buttons on pins A2-A7 pull their pin low
+// when pressed, and the 'input' task samples 'GPIOA->IDR' at
+// 1KHz; the masks use the pins' bit positions in 'IDR'.
+#define BUTTON_LEFT       (1 << 2)
+#define BUTTON_UP         (1 << 3)
+#define BUTTON_DOWN       (1 << 4)
+#define BUTTON_RIGHT      (1 << 5)
+#define BUTTON_B          (1 << 6)
+#define BUTTON_A          (1 << 7)
+#define BUTTON_ALL        (0xFC)
+// Each button's press event is its pin number minus 1.
+#define BUTTON_PIN_FIRST  (2)
+#define BUTTON_PIN_LAST   (7)
+#define INPUT_SAMPLE_US   (1000)
+// Debounced buttons which are currently held down.
+uint8_t input_held;
+// Per-button 2-bit 'vertical' counters: bit N of each byte is
+// one bit of button N's count of samples which disagreed with
+// its debounced state.
+uint8_t input_cnt0;
+uint8_t input_cnt1;
+// When each button's current run of disagreeing samples
+// started, indexed by pin number.
+uint32_t input_edge_us[BUTTON_PIN_LAST + 1];
 
 // Macro definitions for the Tetris grid/bricks.
 // (Note: The brick values should not be changed; the
@@ -56,35 +143,258 @@ volatile uint8_t main_menu_state;
 // Define X/Y boundaries for each brick. Based on a 4x4 grid,
 // with the 'center of rotation' at (1,1).
 // Indices: [ rotation ], [ brick type ].
-// The uint16 value has the 4x4 grid, with each hex digit
+// The uint16 'mask' value has the 4x4 grid, with each hex digit
 // representing a row. Most-Significant Bit = top rows.
 // (Try drawing them out - it helps.)
-static const uint16_t BRICKS[4][7] = {
-  // Ordering is 'I', 'O', 'L', 'J', 'T', 'Z', 'S'.
-  // 'Rotated by 0   degrees'
-  { 0x4444, 0x0660, 0xC440, 0x6440, 0x4E00, 0x4C80, 0x8C40 },
-  // 'Rotated by 90  degrees'
-  { 0x0F00, 0x0660, 0x2E00, 0x0E20, 0x4640, 0xC600, 0x6C00 },
-  // 'Rotated by 180 degrees'
-  { 0x2222, 0x0660, 0x4460, 0x44C0, 0x0E40, 0x2640, 0x4620 },
-  // 'Rotated by 270 degrees'
-  { 0x00F0, 0x0660, 0x0E80, 0x8E00, 0x4C40, 0x0C60, 0x06C0 }
-};
+// The rest of each entry is worked out from the mask at compile
+// time by the 'BRICK_STATE' macro, so that collision checks and
+// drawing don't need to decode it bit-by-bit:
+//   - rows:  A bitmask for each row of the 4x4 grid, shifted so
+//            that bit 0 is column 'min_x'. Bit N is column N+min_x.
+//   - min_x/max_x/min_y/max_y: The filled extents in the 4x4 grid.
+//   - cells: The 4 filled cells, as ((y << 4) | x).
+typedef struct {
+  uint16_t mask;
+  uint8_t  rows[4];
+  int8_t   min_x;
+  int8_t   max_x;
+  int8_t   min_y;
+  int8_t   max_y;
+  uint8_t  cells[4];
+} brick_state_t;
+// Row 'iy' of a mask, with the leftmost cell in the MSB.
+#define BRICK_ROW(m, iy)  (((m) >> (12 - ((iy) * 4))) & 0xF)
+// Which columns have any filled cells, leftmost in the MSB.
+#define BRICK_COLS(m)     (BRICK_ROW(m, 0) | BRICK_ROW(m, 1) | \
+                           BRICK_ROW(m, 2) | BRICK_ROW(m, 3))
+#define BRICK_MIN_X(m)    ((BRICK_COLS(m) & 0x8) ? 0 : \
+                           (BRICK_COLS(m) & 0x4) ? 1 : \
+                           (BRICK_COLS(m) & 0x2) ? 2 : 3)
+#define BRICK_MAX_X(m)    ((BRICK_COLS(m) & 0x1) ? 3 : \
+                           (BRICK_COLS(m) & 0x2) ? 2 : \
+                           (BRICK_COLS(m) & 0x4) ? 1 : 0)
+#define BRICK_MIN_Y(m)    (BRICK_ROW(m, 0) ? 0 : BRICK_ROW(m, 1) ? 1 : \
+                           BRICK_ROW(m, 2) ? 2 : 3)
+#define BRICK_MAX_Y(m)    (BRICK_ROW(m, 3) ? 3 : BRICK_ROW(m, 2) ? 2 : \
+                           BRICK_ROW(m, 1) ? 1 : 0)
+// Reverse a row nibble, so that the leftmost cell is in the LSB.
+#define BRICK_NIB_REV(n)  ((((n) & 0x1) << 3) | (((n) & 0x2) << 1) | \
+                           (((n) & 0x4) >> 1) | (((n) & 0x8) >> 3))
+#define BRICK_ROW_MASK(m, iy) (BRICK_NIB_REV(BRICK_ROW(m, iy)) >> BRICK_MIN_X(m))
+// Cell 'i' of the 4x4 grid, counting left-to-right, top-to-bottom.
+#define BRICK_BIT(m, i)   (((m) >> (15 - (i))) & 0x1)
+#define BRICK_POP4(n)     (((n) & 0x1) + (((n) >> 1) & 0x1) + \
+                           (((n) >> 2) & 0x1) + (((n) >> 3) & 0x1))
+#define BRICK_POP16(v)    (BRICK_POP4((v) & 0xF) + BRICK_POP4(((v) >> 4) & 0xF) + \
+                           BRICK_POP4(((v) >> 8) & 0xF) + BRICK_POP4(((v) >> 12) & 0xF))
+// How many cells are filled before cell 'i'.
+#define BRICK_POP_BEFORE(m, i) BRICK_POP16(((m) & 0xFFFF) >> (16 - (i)))
+// The packed coordinates of cell 'i' if it is the k'th filled cell, or 0.
+#define BRICK_CELL_IS(m, i, k) ((BRICK_BIT(m, i) && (BRICK_POP_BEFORE(m, i) == (k))) ? \
+                                ((((i) / 4) << 4) | ((i) % 4)) : 0)
+#define BRICK_CELL(m, k)  (BRICK_CELL_IS(m,  0, k) | BRICK_CELL_IS(m,  1, k) | \
+                           BRICK_CELL_IS(m,  2, k) | BRICK_CELL_IS(m,  3, k) | \
+                           BRICK_CELL_IS(m,  4, k) | BRICK_CELL_IS(m,  5, k) | \
+                           BRICK_CELL_IS(m,  6, k) | BRICK_CELL_IS(m,  7, k) | \
+                           BRICK_CELL_IS(m,  8, k) | BRICK_CELL_IS(m,  9, k) | \
+                           BRICK_CELL_IS(m, 10, k) | BRICK_CELL_IS(m, 11, k) | \
+                           BRICK_CELL_IS(m, 12, k) | BRICK_CELL_IS(m, 13, k) | \
+                           BRICK_CELL_IS(m, 14, k) | BRICK_CELL_IS(m, 15, k))
+#define BRICK_STATE(m) { (m), \
+  { BRICK_ROW_MASK(m, 0), BRICK_ROW_MASK(m, 1), \
+    BRICK_ROW_MASK(m, 2), BRICK_ROW_MASK(m, 3) }, \
+  BRICK_MIN_X(m), BRICK_MAX_X(m), BRICK_MIN_Y(m), BRICK_MAX_Y(m), \
+  { BRICK_CELL(m, 0), BRICK_CELL(m, 1), BRICK_CELL(m, 2), BRICK_CELL(m, 3) } }
+extern const brick_state_t BRICKS[4][7];
 // The Tetris grid; use a full byte per pixel. It's a
 // bit profligate, but we'll want to store color
 // in the V2 board and it'll make the math simple.
-volatile unsigned char tetris_grid[10][20];
+unsigned char tetris_grid[10][20];
+// Occupancy 'bitboard' for the grid, kept alongside the
+// color/type grid above. Each row is a bitmask, with bit N
+// set if column N is filled; a full row is 0x3FF.
+#define TROW_FULL     (0x03FF)
+uint16_t tetris_rows[20];
+// The rows which were cleared when the last brick was fixed in
+// place, bottom-up, and how many of them there were.
+uint8_t tetris_cleared_rows[4];
+uint8_t tetris_num_cleared;
+// Scoring and progression. Line clears score 40/100/300/1200
+// points (for 1-4 rows) times 'level + 1', and the level goes up
+// every 'TETRIS_LINES_PER_LEVEL' lines.
+#define TETRIS_LINES_PER_LEVEL (10)
+extern const uint16_t TETRIS_LINE_SCORES[5];
+uint32_t tetris_score;
+uint16_t tetris_lines;
+uint8_t tetris_level;
+// Lines left to clear before the next level.
+uint8_t tetris_level_lines_left;
+// The game logic runs on a fixed 60Hz clock, from the
+// scheduler's 'game' task.
+#define TETRIS_FRAME_US (16667)
+// Gravity is measured in 'G'; 1G drops the brick by one row
+// per frame. It is stored as a 16.16 fixed-point fraction
+// of a row, and added to an accumulator every frame, which
+// drops the brick by a row each time it passes 1G. (Rounded
+// up, so that 'N frames per row' takes exactly N frames.)
+#define TETRIS_G_ONE          (0x00010000)
+#define TETRIS_G_FRAMES(f)    ((TETRIS_G_ONE + (f) - 1) / (f))
+// Gravity curve for each level; the last level is '20G',
+// which drops bricks straight to the bottom. Levels past the
+// end of the table use its last entry.
+#define TETRIS_GRAVITY_LEVELS (21)
+extern const uint32_t TETRIS_GRAVITY[TETRIS_GRAVITY_LEVELS];
+uint32_t tetris_gravity_acc;
+// Lock delay: a brick which can't drop any further is fixed
+// in place after resting for this many frames. The count
+// restarts whenever the brick drops to a new row.
+#define TETRIS_LOCK_DELAY_FRAMES (30)
+uint8_t tetris_lock_frames;
+// Holding 'Down' soft drops the brick: it falls at least this
+// fast, on top of the row it drops as soon as 'Down' is pressed.
+#define TETRIS_SOFT_DROP_G (TETRIS_G_ONE)
+// Delayed auto-shift: holding 'Left' or 'Right' moves the brick
+// once, then again after 'TETRIS_DAS_FRAMES', and from then on
+// every 'TETRIS_ARR_FRAMES' (at least 1) until it is let go.
+#define TETRIS_DAS_FRAMES  (10)
+#define TETRIS_ARR_FRAMES  (2)
+// The button being auto-shifted ('BUTTON_LEFT' or 'BUTTON_RIGHT',
+// or 0), and how many frames it has been held for.
+uint8_t tetris_das_button;
+uint8_t tetris_das_frames;
+// The row which the current brick would land on if it dropped
+// straight down. It is kept up to date whenever the brick moves
+// sideways, rotates or is replaced, so that gravity and the 'Up'
+// hard drop don't have to search for the stack every time.
+int8_t tetris_ghost_y;
+// The counter values currently drawn on the game screen, so
+// that they are only redrawn when they change.
+// The counters are drawn in the panel between the border and
+// the grid, which is 'TETRIS_PANEL_W' pixels wide.
+#define TETRIS_PANEL_X (18)
+#define TETRIS_PANEL_W (28)
+uint32_t tetris_drawn_score;
+uint16_t tetris_drawn_lines;
+uint8_t tetris_drawn_level;
 // Store information about the current block.
-volatile uint8_t cur_block_type;
-volatile int8_t cur_block_x;
-volatile int8_t cur_block_y;
-volatile int8_t cur_block_r;
+uint8_t cur_block_type;
+int8_t cur_block_x;
+int8_t cur_block_y;
+int8_t cur_block_r;
 
-// Buffer for the OLED screen.
+// Buffers for the OLED screen.
 // Currently only supports 128x64-px monochrome.
 // (1 Byte = 8 pixels)
+// There are two buffers; the drawing methods write to the 'back'
+// buffer ('oled_fb') while the 'front' buffer is sent to the
+// display. 'oled_present' swaps them once a frame is finished.
 #define OLED_FB_SIZE (128*64)/8
-volatile unsigned char oled_fb[OLED_FB_SIZE];
+unsigned char oled_fb_bufs[2][OLED_FB_SIZE] __attribute__((aligned(4)));
+unsigned char *oled_fb;
+unsigned char *oled_fb_front;
+// State of the DMA-driven display update.
+// 'SENDING' lasts until the last window's 'stop' condition has
+// been sent; only the 'front' buffer is read in the meantime, so
+// the 'back' buffer can be drawn to, but not presented.
+#define OLED_FB_DMA_IDLE     (0)
+#define OLED_FB_DMA_SENDING  (1)
+volatile uint8_t oled_fb_dma_state;
+// Number of bytes in the current DMA-driven I2C transfer which
+// have not been covered by an 'NBYTES' value yet.
+volatile uint16_t i2c_dma_bytes_left;
+// Dirty-region tracking for partial display updates.
+// Each of the 8 pages records the first and last column which
+// were drawn to since the last update; 'x0 > x1' means 'clean'.
+#define OLED_PAGES          (8)
+#define OLED_DIRTY_CLEAN_X0 (0xFF)
+#define OLED_DIRTY_CLEAN_X1 (0x00)
+uint8_t oled_dirty_x0[OLED_PAGES];
+uint8_t oled_dirty_x1[OLED_PAGES];
+// The regions being sent by the current display update, and the
+// progress through them. Each page is sent as an SSD1306 column/
+// page addressing command, followed by that window's data.
+volatile uint8_t oled_update_x0[OLED_PAGES];
+volatile uint8_t oled_update_x1[OLED_PAGES];
+#define OLED_UPDATE_PHASE_CMD  (0)
+#define OLED_UPDATE_PHASE_DATA (1)
+volatile uint8_t oled_update_page;
+volatile uint8_t oled_update_last_page;
+volatile uint8_t oled_update_phase;
+volatile unsigned char oled_update_cmd[6];
+// Which screen the framebuffer currently holds. Screens are only
+// drawn in full when this changes; 0xFF means 'nothing yet'.
+#define OLED_SCREEN_NONE    (0xFF)
+uint8_t oled_drawn_screen;
+// Which grid cells were filled in the last frame, one bit
+// per column. Used to only redraw cells that changed.
+uint16_t tetris_drawn_rows[20];
+// Frame pacing. The 'render' task is released once per
+// 'FRAME_TARGET_US', in step with the game clock, and only draws
+// a frame if the game state or the debug overlay changed. A frame
+// which is drawn while the last one is still being sent waits in
+// the back buffer, and is presented by the next release.
+#define FRAME_TARGET_US       (TETRIS_FRAME_US)
+// Set when the back buffer holds a frame which hasn't been
+// presented yet.
+uint8_t oled_present_pending;
+// Frame statistics are collected over windows of this length.
+#define FRAME_STATS_WINDOW_US (1000000)
+typedef struct {
+  // The current window: when it started, how many frames were
+  // drawn and skipped (drawn over before they were presented),
+  // and how long the drawn frames took to build, and to start
+  // sending if the bus was free.
+  uint32_t window_start_us;
+  uint16_t frames;
+  uint16_t skipped;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint32_t total_us;
+  // The last complete window, and how many there have been.
+  uint16_t window;
+  uint16_t last_frames;
+  uint16_t last_skipped;
+  uint32_t last_min_us;
+  uint32_t last_avg_us;
+  uint32_t last_max_us;
+} frame_stats_t;
+frame_stats_t frame_stats;
+// Debug overlay for the last window's frame statistics, in the
+// right-hand margin outside of every screen's border: frames,
+// skipped frames, and min/avg/max frame time in microseconds.
+// 'Up' turns it on and off from the main menu.
+#define FRAME_OVERLAY_X       (112)
+#define FRAME_OVERLAY_W       (16)
+#define FRAME_OVERLAY_ROWS    (5)
+#define FRAME_OVERLAY_ROW_H   (7)
+uint8_t frame_overlay_on;
+// The screen and stats window which the overlay was drawn for.
+uint8_t frame_overlay_screen;
+uint16_t frame_overlay_window;
+// Pre-rendered background layer for the static parts of a
+// screen, such as the playfield's border and grid lines.
+// There is one 1KB slot, keyed by the screen which was
+// rendered into it; 'OLED_SCREEN_NONE' means 'empty'.
+unsigned char oled_bg[OLED_FB_SIZE] __attribute__((aligned(4)));
+uint8_t oled_bg_screen;
+// Cache of rasterised text strips, for static labels which are
+// drawn again each time their screen's background is rebuilt.
+// Each slot holds one string's final column bits (up to 16
+// pixels tall), keyed by the string's pointer, size and color.
+// The slots share one pool of columns; when a new string doesn't
+// fit in it, the whole cache is emptied and refilled.
+#define OLED_TEXT_CACHE_SLOTS (4)
+#define OLED_TEXT_CACHE_COLS  (208)
+typedef struct {
+  const char *str;
+  char size;
+  unsigned char color;
+  uint8_t start;
+  uint8_t width;
+} oled_text_slot_t;
+oled_text_slot_t oled_text_cache[OLED_TEXT_CACHE_SLOTS];
+uint16_t oled_text_cache_cols[OLED_TEXT_CACHE_COLS];
+uint8_t oled_text_cache_used;
 // Buffer for drawing lines of text to the OLED.
 char oled_line_buf[24];
 
@@ -197,4 +507,55 @@ char oled_line_buf[24];
 #define OLED_CH_rct0     0x00442810
 #define OLED_CH_lct1rct1 0x00000000
 
+// ASCII-indexed font table, built from the words above at
+// compile time. Each glyph is 6 ready-to-blit column bytes in
+// the framebuffer's layout, with the top pixel in bit 0; the
+// 'OLED_CH_*' words store the top pixel in the MSB, so each
+// byte is bit-reversed. Characters without a glyph are blank.
+#define OLED_REV8(b) ((uint8_t)((((b) & 0x01) << 7) | \
+                                (((b) & 0x02) << 5) | \
+                                (((b) & 0x04) << 3) | \
+                                (((b) & 0x08) << 1) | \
+                                (((b) & 0x10) >> 1) | \
+                                (((b) & 0x20) >> 3) | \
+                                (((b) & 0x40) >> 5) | \
+                                (((b) & 0x80) >> 7)))
+#define OLED_GLYPH(w0, w1) { OLED_REV8((w0) >> 24), \
+                             OLED_REV8((w0) >> 16), \
+                             OLED_REV8((w0) >> 8),  \
+                             OLED_REV8(w0),         \
+                             OLED_REV8((w1) >> 8),  \
+                             OLED_REV8(w1) }
+// Each 'w1' word holds the last 2 columns of two characters.
+#define OLED_GLYPH_HI(w0, w01) OLED_GLYPH(w0, ((w01) >> 16))
+#define OLED_GLYPH_LO(w0, w01) OLED_GLYPH(w0, ((w01) & 0xFFFF))
+#define OLED_GLYPH_W    (6)
+// 2x-scaled column bytes for size 'L' text: each nibble's
+// bits are doubled, so a byte becomes a 16-pixel column.
+extern const uint8_t OLED_NIB_SCALE2[16];
+#define OLED_SCALE2(b) (OLED_NIB_SCALE2[(b) & 0x0F] | \
+                        (OLED_NIB_SCALE2[((b) >> 4) & 0x0F] << 8))
+#define OLED_FONT_FIRST (' ')
+#define OLED_FONT_LAST  ('z')
+extern const uint8_t OLED_FONT[OLED_FONT_LAST - OLED_FONT_FIRST + 1][OLED_GLYPH_W];
+
+
+// Proportional fonts, generated from the BDF sources in ./fonts
+// by 'make fonts'. Each glyph's columns are packed into 'data'
+// starting at 'offset', with 'height / 8' bytes per column (low
+// page first). 'advance' includes the spacing after the glyph.
+typedef struct {
+  uint16_t offset;
+  uint8_t width;
+  uint8_t advance;
+} font_glyph_t;
+typedef struct {
+  uint8_t height;
+  uint8_t first;
+  uint8_t last;
+  const font_glyph_t *glyphs;
+  const uint8_t *data;
+} font_t;
+#include "font_data.h"
+
 #endif
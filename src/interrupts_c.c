@@ -19,100 +19,27 @@ inline void EXTI1_line_interrupt(void) {
 }
 
 inline void EXTI2_line_interrupt(void) {
-  // 'Left' button.
-  if (game_state == GAME_STATE_IN_GAME) {
-    // Move the brick left, if possible.
-    if (!check_brick_pos(cur_block_x-1, cur_block_y)) {
-      cur_block_x -= 1;
-    }
-  }
+  // (Unused)
 }
 
 inline void EXTI3_line_interrupt(void) {
-  // 'Up' button.
-  if (game_state == GAME_STATE_IN_GAME) {
-    // For now, 'Up' goes back to the main menu for debugging.
-    game_state = GAME_STATE_MAIN_MENU;
-    main_menu_state = MAIN_MENU_STATE_START;
-    uled_state = 0;
-    stop_timer(TIM2);
-  }
+  // (Unused)
 }
 
 inline void EXTI4_line_interrupt(void) {
-  // 'Down' button.
+  // (Unused)
 }
 
 inline void EXTI5_line_interrupt(void) {
-  // 'Right' button.
-  if (game_state == GAME_STATE_IN_GAME) {
-    // Move the brick right, if possible.
-    if (!check_brick_pos(cur_block_x+1, cur_block_y)) {
-      cur_block_x += 1;
-    }
-  }
+  // (Unused)
 }
 
 inline void EXTI6_line_interrupt(void) {
-  // 'B' button.
-  if (game_state == GAME_STATE_MAIN_MENU) {
-  }
-  else if (game_state == GAME_STATE_IN_GAME) {
-    // Rotate the brick clockwise, if able.
-    if (!check_brick_rot((cur_block_r - 1) % 4)) {
-      cur_block_r = (cur_block_r - 1) % 4;
-    }
-  }
-  else if (game_state == GAME_STATE_PAUSED) {
-  }
-  else if (game_state == GAME_STATE_GAME_OVER) {
-    // Either the 'A' or 'B' button returns to the
-    // main menu from a 'Game Over' screen.
-    game_state = GAME_STATE_MAIN_MENU;
-    main_menu_state = MAIN_MENU_STATE_START;
-    uled_state = 0;
-    stop_timer(TIM2);
-    reset_game_state();
-  }
+  // (Unused)
 }
 
 inline void EXTI7_line_interrupt(void) {
-  // 'A' button.
-  if (game_state == GAME_STATE_MAIN_MENU) {
-    if (main_menu_state == MAIN_MENU_STATE_START) {
-      // Start a new game!
-      game_state = GAME_STATE_IN_GAME;
-      uled_state = 0;
-      // Set a PRNG-based first block type.
-      uint8_t new_block_type = TIM3->CNT & 0x7;
-      // (Valid block types are between [0:6])
-      while (new_block_type == 7) { new_block_type = TIM3->CNT & 0x7; }
-      cur_block_type = new_block_type;
-      // For a basic timer, use a prescaler of 1024.
-      // 48MHz/1024 ~= 46.875KHz.
-      // Use 46,875 'ticks' at 46.875KHz to trigger ~every second.
-      //start_timer(TIM2, 1024, 46875, 1);
-      // Or go a bit faster, for debugging.
-      start_timer(TIM2, 1024, 10000, 1);
-    }
-  }
-  else if (game_state == GAME_STATE_IN_GAME) {
-    // Rotate the brick counter-clockwise, if able.
-    if (!check_brick_rot((cur_block_r + 1) % 4)) {
-      cur_block_r = (cur_block_r + 1) % 4;
-    }
-  }
-  else if (game_state == GAME_STATE_PAUSED) {
-  }
-  else if (game_state == GAME_STATE_GAME_OVER) {
-    // Either the 'A' or 'B' button returns to the
-    // main menu from a 'Game Over' screen.
-    game_state = GAME_STATE_MAIN_MENU;
-    main_menu_state = MAIN_MENU_STATE_START;
-    uled_state = 0;
-    stop_timer(TIM2);
-    reset_game_state();
-  }
+  // (Unused)
 }
 
 inline void EXTI8_line_interrupt(void) {
@@ -234,6 +161,16 @@ if (EXTI->PR & EXTI_PR_PR15) {
 return;
 }
 
+/*
+ * I2C1: Handle 'NBYTES' reloads and chain display update transfers.
+ */
+void I2C1_IRQ_handler(void) {
+  if (i2c_dma_irq(I2C1, I2C1_TX_DMA_CHANNEL)) {
+    // Start the next part of the display update, if any.
+    ssd1306_update_next(I2C1);
+  }
+}
+
 
 #elif VVC_F3
 // STM32F3xx(?) EXTI lines.
@@ -280,19 +217,7 @@ return;
 #endif
 
 // Interrupts common to all supported chips.
-void TIM2_IRQ_handler(void) {
-  // Handle a timer 'update' interrupt event
-  if (TIM2->SR & TIM_SR_UIF) {
-    TIM2->SR &= ~(TIM_SR_UIF);
-    uled_state = !uled_state;
-    if (game_state == GAME_STATE_IN_GAME) {
-      tetris_game_tick();
-    }
-  }
-}
-
-void TIM14_IRQ_handler(void) {
-  if (TIM14->SR & TIM_SR_UIF) {
-    TIM14->SR &= ~(TIM_SR_UIF);
-  }
+void SysTick_handler(void) {
+  // Count the system clock's milliseconds.
+  ++clock_ms;
 }
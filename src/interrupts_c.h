@@ -36,6 +36,8 @@ void EXTI0_1_IRQ_handler(void);
 void EXTI2_3_IRQ_handler(void);
 // EXTI handler for interrupt lines 4-15.
 void EXTI4_15_IRQ_handler(void);
+// I2C1 event/error handler.
+void I2C1_IRQ_handler(void);
 #elif VVC_F3
 // STM32F3xx(?) EXTI lines.
 // EXTI handler for interrupt line 0.
@@ -55,7 +57,6 @@ void EXTI5_9_IRQ_handler(void);
 #endif
 
 // Handlers common to all supported lines of chip.
-void TIM2_IRQ_handler(void);
-void TIM14_IRQ_handler(void);
+void SysTick_handler(void);
 
 #endif
@@ -0,0 +1,94 @@
+#include "latency.h"
+#include "util_c.h"
+
+/*
+ * Empty the histograms and stop following any press.
+ */
+void latency_reset(void) {
+  uint8_t stage;
+  uint8_t bucket;
+  latency_probe_state = LATENCY_PROBE_IDLE;
+  for (stage = 0; stage < LATENCY_STAGES; ++stage) {
+    latency_hists[stage].count = 0;
+    latency_hists[stage].min = 0xFFFFFFFF;
+    latency_hists[stage].max = 0;
+    latency_hists[stage].total = 0;
+    for (bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+      latency_hists[stage].buckets[bucket] = 0;
+    }
+  }
+}
+
+/*
+ * Add one time to a stage's histogram.
+ */
+void latency_record(uint8_t stage, uint32_t us) {
+  latency_hist_t *hist = &latency_hists[stage];
+  uint8_t bucket = 0;
+  // (The Cortex-M0 has no 'CLZ' instruction.)
+  while ((us >> (bucket + 1)) && bucket < (LATENCY_BUCKETS - 1)) {
+    ++bucket;
+  }
+  ++hist->count;
+  hist->total += us;
+  if (us < hist->min) { hist->min = us; }
+  if (us > hist->max) { hist->max = us; }
+  if (hist->buckets[bucket] < 0xFFFF) { ++hist->buckets[bucket]; }
+}
+
+/*
+ * Called after an event is applied to the game state. If no
+ * press is being followed, start following this one.
+ */
+void latency_event_applied(const game_event_t *ev) {
+  if (latency_probe_state != LATENCY_PROBE_IDLE ||
+      ev->type == EVENT_NONE || ev->type == EVENT_GAME_FRAME) {
+    return;
+  }
+  latency_probe_times[LATENCY_STAGE_INPUT] = ev->time;
+  latency_probe_times[LATENCY_STAGE_RENDER] = clock_us();
+  COMPILER_BARRIER();
+  latency_probe_state = LATENCY_PROBE_APPLIED;
+}
+
+/*
+ * Called after a frame is drawn into the back buffer. The events
+ * are applied before each frame, so this is the press's frame.
+ */
+void latency_frame_drawn(void) {
+  if (latency_probe_state != LATENCY_PROBE_APPLIED) { return; }
+  latency_probe_times[LATENCY_STAGE_DISPLAY] = clock_us();
+  COMPILER_BARRIER();
+  latency_probe_state = LATENCY_PROBE_DRAWN;
+}
+
+/*
+ * Called when a display update starts. The previous update can
+ * still be running while the press's frame is drawn, so the probe
+ * only waits for the end of an update once its frame is the one
+ * being sent.
+ */
+void latency_frame_sending(void) {
+  if (latency_probe_state != LATENCY_PROBE_DRAWN) { return; }
+  latency_probe_state = LATENCY_PROBE_SENDING;
+}
+
+/*
+ * Called when a display update finishes, or when there turns
+ * out to be nothing to send. This is usually called from the
+ * I2C interrupt handler.
+ */
+void latency_frame_shown(void) {
+  if (latency_probe_state != LATENCY_PROBE_SENDING) { return; }
+  uint32_t now = clock_us();
+  uint32_t *t = latency_probe_times;
+  latency_record(LATENCY_STAGE_INPUT,
+                 t[LATENCY_STAGE_RENDER] - t[LATENCY_STAGE_INPUT]);
+  latency_record(LATENCY_STAGE_RENDER,
+                 t[LATENCY_STAGE_DISPLAY] - t[LATENCY_STAGE_RENDER]);
+  latency_record(LATENCY_STAGE_DISPLAY,
+                 now - t[LATENCY_STAGE_DISPLAY]);
+  latency_record(LATENCY_STAGE_TOTAL,
+                 now - t[LATENCY_STAGE_INPUT]);
+  latency_probe_state = LATENCY_PROBE_IDLE;
+}
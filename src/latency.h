@@ -0,0 +1,62 @@
+#ifndef _VVC_LATENCY_H
+#define _VVC_LATENCY_H
+
+#include "global.h"
+
+// Input latency probe, from a button press to the frame
+// which shows its effect being on the screen.
+// One press at a time is followed through the pipeline, and the
+// time it spends in each stage is added to a histogram:
+//   - INPUT:   Press first sampled -> applied to the game state;
+//              this includes the 4ms of debouncing.
+//   - RENDER:  Applied -> frame drawn into the back buffer.
+//   - DISPLAY: Drawn -> last byte of the update sent over I2C.
+//   - TOTAL:   Press first sampled -> on the screen.
+// Times are in microseconds (see 'clock_us').
+#define LATENCY_STAGE_INPUT   (0)
+#define LATENCY_STAGE_RENDER  (1)
+#define LATENCY_STAGE_DISPLAY (2)
+#define LATENCY_STAGE_TOTAL   (3)
+#define LATENCY_STAGES        (4)
+// Bucket N counts times in [2^N, 2^(N+1)) us; bucket 0 also
+// counts 0us, and the last bucket counts everything longer.
+#define LATENCY_BUCKETS       (16)
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint32_t total;
+  uint16_t buckets[LATENCY_BUCKETS];
+} latency_hist_t;
+
+#ifdef VVC_LATENCY
+// Where the press being followed has got to.
+#define LATENCY_PROBE_IDLE    (0)
+#define LATENCY_PROBE_APPLIED (1)
+#define LATENCY_PROBE_DRAWN   (2)
+#define LATENCY_PROBE_SENDING (3)
+// The probe is advanced from the main loop, except for the
+// last step, which happens in the I2C interrupt handler.
+volatile uint8_t latency_probe_state;
+uint32_t latency_probe_times[LATENCY_STAGES];
+
+// The histograms, so that a debugger can read them on the chip.
+latency_hist_t latency_hists[LATENCY_STAGES];
+
+void latency_reset(void);
+void latency_record(uint8_t stage, uint32_t us);
+void latency_event_applied(const game_event_t *ev);
+void latency_frame_drawn(void);
+void latency_frame_sending(void);
+void latency_frame_shown(void);
+#else
+// Without 'VVC_LATENCY', the probe points compile to nothing.
+#define latency_reset()           ((void)0)
+#define latency_event_applied(ev) ((void)0)
+#define latency_frame_drawn()     ((void)0)
+#define latency_frame_sending()   ((void)0)
+#define latency_frame_shown()     ((void)0)
+#endif
+
+#endif
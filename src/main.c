@@ -5,21 +5,7 @@
  */
 int main(void) {
   // Define starting values for global variables.
-  uled_state = 0;
-  game_state = GAME_STATE_MAIN_MENU;
-  main_menu_state = MAIN_MENU_STATE_START;
-  cur_block_type = TBRICK_I;
-  cur_block_x = 4;
-  cur_block_y = -1;
-  cur_block_r = 0;
-  // Empty the tetris grid, to start.
-  uint8_t grid_x_i = 0;
-  uint8_t grid_y_i = 0;
-  for (grid_x_i = 0; grid_x_i < 10; ++grid_x_i) {
-    for (grid_y_i = 0; grid_y_i < 20; ++grid_y_i) {
-      tetris_grid[grid_x_i][grid_y_i] = TGRID_EMPTY;
-    }
-  }
+  game_init();
 
   // Enable the GPIOA clock (buttons on pins A2-A7,
   // user LED on pin A12).
@@ -27,16 +13,19 @@ int main(void) {
   // Enable the GPIOB clock (I2C1 used on pins B6/B7,
   // buzzer on pin B0).
   RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
-  // Enable the TIM2 clock.
-  RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
-  // Enable the TIM14 clock.
+  // Enable the DMA1 clock (I2C1 TX uses channel 2).
+  RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+  // Enable the TIM3 clock.
   RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
   // Enable the I2C1 clock.
   RCC->APB1ENR |= RCC_APB1ENR_I2C1EN;
-  // Enable the SYSCFG clock for hardware interrupts.
-  RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
 
-  // Start the TIM14 clock to count rapidly.
+  // Start the system clock. Its interrupt has the highest
+  // priority, so the millisecond count is always current.
+  clock_init();
+  NVIC_SetPriority(SysTick_IRQn, 0x00);
+
+  // Start the TIM3 clock to count rapidly.
   // This will be a rudimentary PRNG.
   start_timer(TIM3, 0, 0xFFFF, 0);
 
@@ -133,104 +122,32 @@ int main(void) {
   // Initialize the SSD1306 OLED display.
   ssd1306_start_sequence(I2C1);
 
-  // Setup hardware interrupts on the EXTI lines associated
-  // with the 6 button inputs.
-  // Pins A2, A3 use the EXTI2_3 interrupt.
-  // Pins A4, A5, A6, and A7 use the EXTI4_15 interrupt.
-  // Map EXTI lines to the GPIOA port. (This is 0x00, but...)
-  SYSCFG->EXTICR[0] &= ~(SYSCFG_EXTICR1_EXTI2);
-  SYSCFG->EXTICR[0] |=  (SYSCFG_EXTICR1_EXTI2_PA);
-  SYSCFG->EXTICR[0] &= ~(SYSCFG_EXTICR1_EXTI3);
-  SYSCFG->EXTICR[0] |=  (SYSCFG_EXTICR1_EXTI3_PA);
-  SYSCFG->EXTICR[1] &= ~(SYSCFG_EXTICR2_EXTI4);
-  SYSCFG->EXTICR[1] |=  (SYSCFG_EXTICR2_EXTI4_PA);
-  SYSCFG->EXTICR[1] &= ~(SYSCFG_EXTICR2_EXTI5);
-  SYSCFG->EXTICR[1] |=  (SYSCFG_EXTICR2_EXTI5_PA);
-  SYSCFG->EXTICR[1] &= ~(SYSCFG_EXTICR2_EXTI6);
-  SYSCFG->EXTICR[1] |=  (SYSCFG_EXTICR2_EXTI6_PA);
-  SYSCFG->EXTICR[1] &= ~(SYSCFG_EXTICR2_EXTI7);
-  SYSCFG->EXTICR[1] |=  (SYSCFG_EXTICR2_EXTI7_PA);
-  // Setup the EXTI interrupt lines as 'falling edge' interrupts.
-  EXTI->IMR  |=  (EXTI_IMR_MR2);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR2);
-  EXTI->FTSR |=  (EXTI_FTSR_TR2);
-  EXTI->IMR  |=  (EXTI_IMR_MR3);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR3);
-  EXTI->FTSR |=  (EXTI_FTSR_TR3);
-  EXTI->IMR  |=  (EXTI_IMR_MR4);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR4);
-  EXTI->FTSR |=  (EXTI_FTSR_TR4);
-  EXTI->IMR  |=  (EXTI_IMR_MR5);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR5);
-  EXTI->FTSR |=  (EXTI_FTSR_TR5);
-  EXTI->IMR  |=  (EXTI_IMR_MR6);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR6);
-  EXTI->FTSR |=  (EXTI_FTSR_TR6);
-  EXTI->IMR  |=  (EXTI_IMR_MR7);
-  EXTI->RTSR &= ~(EXTI_RTSR_TR7);
-  EXTI->FTSR |=  (EXTI_FTSR_TR7);
-
-  // The HAL 'cortex' libraries basically just call these
-  // core functions for NVIC stuff, anyways:
-  #ifdef VVC_F0
-    NVIC_SetPriority(EXTI2_3_IRQn, 0x03);
-    NVIC_EnableIRQ(EXTI2_3_IRQn);
-    NVIC_SetPriority(EXTI4_15_IRQn, 0x03);
-    NVIC_EnableIRQ(EXTI4_15_IRQn);
-  #elif VVC_F3
-    // On Cortex-M4 cores, we need to set an NVIC priority
-    // grouping and subpriorities as well as normal priorities:
-    // 0x07: 0 Pri / 4 SubPri
-    // 0x06: 1 Pri / 3 SubPri
-    // 0x05: 2 Pri / 2 SubPri
-    // 0x04: 3 Pri / 1 SubPri
-    // 0x03: 4 Pri / 0 SubPri
-    // Use 2 bits for 'priority' and 2 bits for 'subpriority'.
-    NVIC_SetPriorityGrouping(0x05);
-    uint32_t exti_pri_encoding = NVIC_EncodePriority(0x05, 0x03, 0x03);
-    NVIC_SetPriority(EXTI2_TSC_IRQn, exti_pri_encoding);
-    NVIC_EnableIRQ(EXTI2_TSC_IRQn);
-    NVIC_SetPriority(EXTI3_IRQn, exti_pri_encoding);
-    NVIC_EnableIRQ(EXTI3_IRQn);
-    NVIC_SetPriority(EXTI4_IRQn, exti_pri_encoding);
-    NVIC_EnableIRQ(EXTI4_IRQn);
-    NVIC_SetPriority(EXTI9_5_IRQn, exti_pri_encoding);
-    NVIC_EnableIRQ(EXTI9_5_IRQn);
+  #ifdef VVC_BENCH
+    // Time the rendering primitives. The results are left in
+    // 'bench_results' for a debugger to read, and the game
+    // state is reset afterwards.
+    bench_run_all(100);
+    game_init();
   #endif
 
-  // Enable the NVIC interrupt for TIM2.
-  // (Timer peripheral initialized and used elsewhere)
-  NVIC_SetPriority(TIM2_IRQn, 0x03);
-  NVIC_EnableIRQ(TIM2_IRQn);
+  // Reset the button state; the 'input' task samples them.
+  input_init();
 
-  while (1) {
-    // Draw the current frame based on the game's state.
-    if (game_state == GAME_STATE_MAIN_MENU) {
-      draw_main_menu();
-    }
-    else if (game_state == GAME_STATE_IN_GAME) {
-      draw_tetris_game();
-    }
-    else if (game_state == GAME_STATE_PAUSED) {
-      // (TODO)
-    }
-    else if (game_state == GAME_STATE_GAME_OVER) {
-      draw_game_over();
-    }
-    else {
-      oled_draw_rect(0, 0, 128, 64, 0, 1);
-    }
-
-    // Communicate the framebuffer to the OLED screen.
-    i2c_stream_framebuffer(I2C1);
+  // Enable the NVIC interrupt for DMA-driven I2C writes.
+  // (The polled I2C methods should not be used after this.)
+  #ifdef VVC_F0
+    NVIC_SetPriority(I2C1_IRQn, 0x02);
+    NVIC_EnableIRQ(I2C1_IRQn);
+  #endif
 
-    // Set the onboard LED if the variable is set.
-    if (uled_state) {
-      GPIOA->ODR |=  (GPIO_ODR_12);
-    }
-    else {
-      GPIOA->ODR &= ~(GPIO_ODR_12);
-    }
-  }
+  // Run the tasks: the buttons are sampled every 1ms, and the
+  // queued presses and game frames are applied and drawn once
+  // per 'FRAME_TARGET_US', in step with the 60Hz game frames.
+  // The 'game' task which queues those frames is started with
+  // a new game. The core sleeps while no task is due.
+  sched_init();
+  sched_start(SCHED_TASK_INPUT);
+  sched_start(SCHED_TASK_RENDER);
+  sched_run();
   return 0;
 }
@@ -5,5 +5,9 @@
 #include "util_c.h"
 #include "interrupts_c.h"
 #include "peripherals.h"
+#include "sched.h"
+#ifdef VVC_BENCH
+  #include "bench.h"
+#endif
 
 #endif
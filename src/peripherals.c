@@ -181,39 +181,110 @@ void i2c_write_data_byte(I2C_TypeDef *I2Cx,
   i2c_stop(I2Cx);
 }
 
-inline void i2c_stream_framebuffer(I2C_TypeDef *I2Cx) {
-  // Stream the entire framebuffer in one transmission.
-  // 1 byte for 'Data/Command', 1024 bytes for the FB.
-  // The NBYTES register can only hold 127 max, so we'll
-  // need to reload that every page or two.
-  uint8_t nbytes_i = 0;
-  uint8_t buf_i = 0;
-  uint16_t buf_prog = 0;
-  // Also, set the 'RELOAD' flag.
-  I2Cx->CR2 |= I2C_CR2_RELOAD;
-  i2c_set_num_bytes(I2Cx, 127);
-  i2c_start(I2Cx);
-  // 'Data'
-  i2c_write_byte(I2Cx, 0x40);
-  // The first 126 bytes.
-  for (nbytes_i = 0; nbytes_i < 126; ++nbytes_i) {
-    i2c_write_byte(I2Cx, oled_fb[nbytes_i]);
+/*
+ * Return how many bytes the next 'NBYTES' chunk of a long
+ * transfer should cover, given how many bytes are left.
+ * A 1025-byte framebuffer write comes out as 127 bytes
+ * (the 'Data' byte plus 126 from the buffer), 7x127 bytes,
+ * and then the last 9 bytes.
+ */
+inline uint8_t i2c_next_chunk_len(uint16_t bytes_left) {
+  if (bytes_left > I2C_DMA_CHUNK_LEN) {
+    return I2C_DMA_CHUNK_LEN;
   }
-  buf_prog += 126;
-  // The next 127 bytes, 7 times.
-  for (buf_i = 0; buf_i < 7; ++buf_i) {
-    i2c_set_num_bytes(I2Cx, 127);
-    for (nbytes_i = 0; nbytes_i < 127; ++nbytes_i) {
-      i2c_write_byte(I2Cx, oled_fb[buf_prog + nbytes_i]);
+  return bytes_left;
+}
+
+/*
+ * Start a DMA-driven write of 'ctrl' followed by 'len' bytes
+ * from 'buf', without waiting for it to finish.
+ * The 'ctrl' byte is pre-loaded into TXDR before the 'start'
+ * condition, and the DMA channel feeds the rest in as TXIS
+ * requests come in. The 'NBYTES' reloads are handled by
+ * 'i2c_dma_irq' on each 'transfer complete reload' event,
+ * which also reports when the 'stop' condition has been sent.
+ * 'buf' must stay valid until the 'stop' condition has
+ * been sent.
+ */
+void i2c_dma_write(I2C_TypeDef *I2Cx,
+                   DMA_Channel_TypeDef *DMAx,
+                   uint8_t ctrl,
+                   volatile void *buf,
+                   uint16_t len) {
+  uint8_t first_chunk = i2c_next_chunk_len(len + 1);
+  i2c_dma_bytes_left = (len + 1) - first_chunk;
+  // Setup the DMA channel: memory -> peripheral, 8-bit
+  // transfers, increment the memory address, medium priority.
+  DMAx->CCR   &= ~(DMA_CCR_EN);
+  DMAx->CPAR   =  (uint32_t)&(I2Cx->TXDR);
+  DMAx->CMAR   =  (uint32_t)buf;
+  DMAx->CNDTR  =  len;
+  DMAx->CCR    =  (DMA_CCR_MINC |
+                   DMA_CCR_DIR  |
+                   DMA_CCR_PL_0);
+  // Setup the I2C transfer size. 'AUTOEND' has no effect
+  // until the 'RELOAD' flag is cleared for the last chunk.
+  I2Cx->CR2   &= ~(I2C_CR2_NBYTES |
+                   I2C_CR2_RELOAD);
+  I2Cx->CR2   |=  ((first_chunk << I2C_CR2_NBYTES_Pos) |
+                   I2C_CR2_AUTOEND);
+  if (i2c_dma_bytes_left) {
+    I2Cx->CR2 |=  (I2C_CR2_RELOAD);
+  }
+  I2Cx->ICR   |=  (I2C_ICR_STOPCF |
+                   I2C_ICR_NACKCF);
+  // Pre-load the control byte, and enable DMA requests
+  // and the 'reload', 'stop', and 'NACK' interrupts.
+  I2Cx->TXDR   =  ctrl;
+  I2Cx->CR1   |=  (I2C_CR1_TXDMAEN |
+                   I2C_CR1_TCIE    |
+                   I2C_CR1_STOPIE  |
+                   I2C_CR1_NACKIE);
+  DMAx->CCR   |=  (DMA_CCR_EN);
+  // Send the 'start' condition; the rest happens in hardware.
+  I2Cx->CR2   |=  (I2C_CR2_START);
+}
+
+/*
+ * Handle I2C interrupts for a DMA-driven write.
+ * This should be called from the I2C peripheral's IRQ handler.
+ * Returns 1 if the transfer finished, 0 if it is still going.
+ */
+uint8_t i2c_dma_irq(I2C_TypeDef *I2Cx,
+                    DMA_Channel_TypeDef *DMAx) {
+  if (I2Cx->ISR & I2C_ISR_TCR) {
+    // Load the next chunk's size; writing 'NBYTES'
+    // clears the 'TCR' flag and releases the bus.
+    uint8_t next_chunk = i2c_next_chunk_len(i2c_dma_bytes_left);
+    i2c_dma_bytes_left -= next_chunk;
+    uint32_t cr2 = I2Cx->CR2;
+    cr2 &= ~(I2C_CR2_NBYTES);
+    cr2 |=  (next_chunk << I2C_CR2_NBYTES_Pos);
+    if (!i2c_dma_bytes_left) {
+      // Last chunk; let 'AUTOEND' send the 'stop' condition.
+      cr2 &= ~(I2C_CR2_RELOAD);
     }
-    buf_prog += 127;
+    I2Cx->CR2 = cr2;
   }
-  // Finally, the last 9 bytes.
-  i2c_set_num_bytes(I2Cx, 9);
-  for (nbytes_i = 0; nbytes_i < 9; ++nbytes_i) {
-    i2c_write_byte(I2Cx, oled_fb[buf_prog + nbytes_i]);
+  if (I2Cx->ISR & I2C_ISR_NACKF) {
+    // The device did not acknowledge; the peripheral sends a
+    // 'stop' condition automatically, so just flush TXDR.
+    I2Cx->ICR |=  (I2C_ICR_NACKCF);
+    I2Cx->ISR |=  (I2C_ISR_TXE);
   }
-  i2c_stop(I2Cx);
-  // Un-set the 'RELOAD' flag.
-  I2Cx->CR2 |= I2C_CR2_RELOAD;
+  if (I2Cx->ISR & I2C_ISR_STOPF) {
+    // The transfer is finished; disable DMA requests and
+    // the transfer interrupts until the next one.
+    I2Cx->ICR |=  (I2C_ICR_STOPCF);
+    I2Cx->CR1 &= ~(I2C_CR1_TXDMAEN |
+                   I2C_CR1_TCIE    |
+                   I2C_CR1_STOPIE  |
+                   I2C_CR1_NACKIE);
+    I2Cx->CR2 &= ~(I2C_CR2_RELOAD |
+                   I2C_CR2_AUTOEND);
+    DMAx->CCR &= ~(DMA_CCR_EN);
+    i2c_dma_bytes_left = 0;
+    return 1;
+  }
+  return 0;
 }
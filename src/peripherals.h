@@ -26,6 +26,19 @@ void i2c_write_command(I2C_TypeDef *I2Cx,
                        uint8_t cmd);
 void i2c_write_data_byte(I2C_TypeDef *I2Cx,
                          uint8_t dat);
-void i2c_stream_framebuffer(I2C_TypeDef *I2Cx);
+
+/* DMA-driven I2C transfers */
+// The STM32F0 maps I2C1_TX to DMA1 channel 2.
+#define I2C1_TX_DMA_CHANNEL DMA1_Channel2
+// The 'NBYTES' chunk size used for long transfers.
+#define I2C_DMA_CHUNK_LEN   (127)
+uint8_t i2c_next_chunk_len(uint16_t bytes_left);
+void i2c_dma_write(I2C_TypeDef *I2Cx,
+                   DMA_Channel_TypeDef *DMAx,
+                   uint8_t ctrl,
+                   volatile void *buf,
+                   uint16_t len);
+uint8_t i2c_dma_irq(I2C_TypeDef *I2Cx,
+                    DMA_Channel_TypeDef *DMAx);
 
 #endif
@@ -0,0 +1,117 @@
+#include "sched.h"
+#include "util_c.h"
+
+// The tasks, in the order that they run in each pass.
+// Input is sampled first so that new presses are queued before
+// the game and render tasks apply them.
+static const sched_task_def_t SCHED_TASK_DEFS[SCHED_NUM_TASKS] = {
+  { "input",  input_sample, INPUT_SAMPLE_US, INPUT_SAMPLE_US },
+  { "game",   game_tick,    TETRIS_FRAME_US, TETRIS_FRAME_US },
+  { "render", game_render,  FRAME_TARGET_US, FRAME_TARGET_US },
+};
+
+/*
+ * Reset the tasks. They all start out stopped.
+ */
+void sched_init(void) {
+  uint8_t i;
+  for (i = 0; i < SCHED_NUM_TASKS; ++i) {
+    sched_tasks[i].def = &SCHED_TASK_DEFS[i];
+    sched_tasks[i].enabled = 0;
+    sched_tasks[i].next_us = 0;
+    sched_tasks[i].runs = 0;
+    sched_tasks[i].overruns = 0;
+    sched_tasks[i].skipped = 0;
+    sched_tasks[i].max_us = 0;
+  }
+}
+
+/*
+ * Start releasing a task. A periodic task joins the phase of
+ * a running task with the same period, so that tasks which
+ * share a period (like the game clock and the renderer) are
+ * released in the same pass; otherwise, it is first released
+ * one period from now.
+ */
+void sched_start(uint8_t task) {
+  uint32_t period = sched_tasks[task].def->period_us;
+  uint32_t next = clock_us() + period;
+  uint8_t i;
+  for (i = 0; period && i < SCHED_NUM_TASKS; ++i) {
+    if (i != task && sched_tasks[i].enabled &&
+        sched_tasks[i].def->period_us == period) {
+      next = sched_tasks[i].next_us;
+      break;
+    }
+  }
+  sched_tasks[task].next_us = next;
+  sched_tasks[task].enabled = 1;
+}
+
+/*
+ * Stop releasing a task.
+ */
+void sched_stop(uint8_t task) {
+  sched_tasks[task].enabled = 0;
+}
+
+/*
+ * Run one task, and update its counters. 'release_us' is when
+ * it was released, which its deadline is measured from. The run
+ * time is measured on 'clock_run_us'.
+ */
+void sched_run_task(uint8_t task, uint32_t release_us) {
+  sched_task_t *t = &sched_tasks[task];
+  uint32_t start = clock_run_us();
+  t->def->run();
+  uint32_t run_us = clock_run_us() - start;
+  ++t->runs;
+  if (run_us > t->max_us) { t->max_us = run_us; }
+  if ((clock_us() - release_us) > t->def->deadline_us) { ++t->overruns; }
+}
+
+/*
+ * Make one pass through the tasks, running each one which has
+ * been released. Periodic tasks keep their phase; if one falls
+ * a whole period behind, the releases which it missed are
+ * skipped rather than run back-to-back.
+ * Returns the number of tasks which ran.
+ */
+uint8_t sched_poll(void) {
+  uint8_t i;
+  uint8_t ran = 0;
+  for (i = 0; i < SCHED_NUM_TASKS; ++i) {
+    sched_task_t *t = &sched_tasks[i];
+    if (!t->enabled) { continue; }
+    uint32_t now = clock_us();
+    uint32_t period = t->def->period_us;
+    if (!period) {
+      sched_run_task(i, now);
+      ++ran;
+      continue;
+    }
+    if ((int32_t)(now - t->next_us) < 0) { continue; }
+    uint32_t release = t->next_us;
+    t->next_us += period;
+    while ((int32_t)(now - t->next_us) >= 0) {
+      t->next_us += period;
+      ++t->skipped;
+    }
+    sched_run_task(i, release);
+    ++ran;
+  }
+  return ran;
+}
+
+/*
+ * Run the scheduler forever; this is the main loop.
+ * When no task was due, the core sleeps until the next
+ * interrupt; SysTick wakes it at least once per millisecond.
+ */
+void sched_run(void) {
+  while (1) {
+    if (!sched_poll()) {
+      __WFI();
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#ifndef _VVC_SCHED_H
+#define _VVC_SCHED_H
+
+#include "global.h"
+
+// Cooperative task scheduler, run from the main loop.
+// Each task is released every 'period_us' microseconds on the
+// SysTick clock (see 'clock_us'), or on every pass through the
+// scheduler if its period is 0. Tasks run to completion in
+// table order, so they never preempt each other; a task which
+// is released again before it gets to run only runs once.
+#define SCHED_TASK_INPUT  (0)
+#define SCHED_TASK_GAME   (1)
+#define SCHED_TASK_RENDER (2)
+#define SCHED_NUM_TASKS   (3)
+
+typedef struct {
+  const char *name;
+  void (*run)(void);
+  uint32_t period_us;
+  // A run which finishes more than this long after its release
+  // counts as an overrun.
+  uint32_t deadline_us;
+} sched_task_def_t;
+
+typedef struct {
+  const sched_task_def_t *def;
+  uint8_t  enabled;
+  // When the task is next released.
+  uint32_t next_us;
+  uint32_t runs;
+  uint32_t overruns;
+  // Releases which were skipped because the task ran too late.
+  uint32_t skipped;
+  // The longest time that one run took.
+  uint32_t max_us;
+} sched_task_t;
+
+// The tasks' state, so that a debugger can read the counters.
+sched_task_t sched_tasks[SCHED_NUM_TASKS];
+
+void sched_init(void);
+void sched_start(uint8_t task);
+void sched_stop(uint8_t task);
+void sched_run_task(uint8_t task, uint32_t release_us);
+uint8_t sched_poll(void);
+void sched_run(void);
+
+#endif
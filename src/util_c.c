@@ -1,5 +1,115 @@
 #include "util_c.h"
 
+// Glyph and scaling tables for the 6x8 font (see global.h).
+const uint8_t OLED_NIB_SCALE2[16] = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+  0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+const uint8_t OLED_FONT[OLED_FONT_LAST - OLED_FONT_FIRST + 1][OLED_GLYPH_W] = {
+  ['!' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_exc0, OLED_CH_exc1fws1),
+  ['+' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_pls0, OLED_CH_hyp1pls1),
+  ['-' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_hyp0, OLED_CH_hyp1pls1),
+  ['.' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_per0, OLED_CH_col1per1),
+  ['/' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_fws0, OLED_CH_exc1fws1),
+  ['0' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_00, OLED_CH_0111),
+  ['1' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_10, OLED_CH_0111),
+  ['2' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_20, OLED_CH_2131),
+  ['3' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_30, OLED_CH_2131),
+  ['4' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_40, OLED_CH_4151),
+  ['5' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_50, OLED_CH_4151),
+  ['6' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_60, OLED_CH_6171),
+  ['7' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_70, OLED_CH_6171),
+  ['8' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_80, OLED_CH_8191),
+  ['9' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_90, OLED_CH_8191),
+  [':' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_col0, OLED_CH_col1per1),
+  ['<' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_lct0, OLED_CH_lct1rct1),
+  ['>' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_rct0, OLED_CH_lct1rct1),
+  ['A' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_A0, OLED_CH_A1B1),
+  ['B' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_B0, OLED_CH_A1B1),
+  ['C' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_C0, OLED_CH_C1D1),
+  ['D' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_D0, OLED_CH_C1D1),
+  ['E' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_E0, OLED_CH_E1F1),
+  ['F' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_F0, OLED_CH_E1F1),
+  ['G' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_G0, OLED_CH_G1H1),
+  ['H' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_H0, OLED_CH_G1H1),
+  ['I' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_I0, OLED_CH_I1J1),
+  ['J' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_J0, OLED_CH_I1J1),
+  ['K' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_K0, OLED_CH_K1L1),
+  ['L' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_L0, OLED_CH_K1L1),
+  ['M' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_M0, OLED_CH_M1N1),
+  ['N' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_N0, OLED_CH_M1N1),
+  ['O' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_O0, OLED_CH_O1P1),
+  ['P' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_P0, OLED_CH_O1P1),
+  ['Q' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_Q0, OLED_CH_Q1R1),
+  ['R' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_R0, OLED_CH_Q1R1),
+  ['S' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_S0, OLED_CH_S1T1),
+  ['T' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_T0, OLED_CH_S1T1),
+  ['U' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_U0, OLED_CH_U1V1),
+  ['V' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_V0, OLED_CH_U1V1),
+  ['W' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_W0, OLED_CH_W1X1),
+  ['X' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_X0, OLED_CH_W1X1),
+  ['Y' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_Y0, OLED_CH_Y1Z1),
+  ['Z' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_Z0, OLED_CH_Y1Z1),
+  ['a' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_a0, OLED_CH_a1b1),
+  ['b' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_b0, OLED_CH_a1b1),
+  ['c' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_c0, OLED_CH_c1d1),
+  ['d' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_d0, OLED_CH_c1d1),
+  ['e' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_e0, OLED_CH_e1f1),
+  ['f' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_f0, OLED_CH_e1f1),
+  ['g' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_g0, OLED_CH_g1h1),
+  ['h' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_h0, OLED_CH_g1h1),
+  ['i' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_i0, OLED_CH_i1j1),
+  ['j' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_j0, OLED_CH_i1j1),
+  ['k' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_k0, OLED_CH_k1l1),
+  ['l' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_l0, OLED_CH_k1l1),
+  ['m' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_m0, OLED_CH_m1n1),
+  ['n' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_n0, OLED_CH_m1n1),
+  ['o' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_o0, OLED_CH_o1p1),
+  ['p' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_p0, OLED_CH_o1p1),
+  ['q' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_q0, OLED_CH_q1r1),
+  ['r' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_r0, OLED_CH_q1r1),
+  ['s' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_s0, OLED_CH_s1t1),
+  ['t' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_t0, OLED_CH_s1t1),
+  ['u' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_u0, OLED_CH_u1v1),
+  ['v' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_v0, OLED_CH_u1v1),
+  ['w' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_w0, OLED_CH_w1x1),
+  ['x' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_x0, OLED_CH_w1x1),
+  ['y' - OLED_FONT_FIRST]  = OLED_GLYPH_HI(OLED_CH_y0, OLED_CH_y1z1),
+  ['z' - OLED_FONT_FIRST]  = OLED_GLYPH_LO(OLED_CH_z0, OLED_CH_y1z1),
+};
+
+// Brick shapes for each rotation (see global.h).
+const brick_state_t BRICKS[4][7] = {
+  // Ordering is 'I', 'O', 'L', 'J', 'T', 'Z', 'S'.
+  // 'Rotated by 0   degrees'
+  { BRICK_STATE(0x4444), BRICK_STATE(0x0660), BRICK_STATE(0xC440),
+    BRICK_STATE(0x6440), BRICK_STATE(0x4E00), BRICK_STATE(0x4C80),
+    BRICK_STATE(0x8C40) },
+  // 'Rotated by 90  degrees'
+  { BRICK_STATE(0x0F00), BRICK_STATE(0x0660), BRICK_STATE(0x2E00),
+    BRICK_STATE(0x0E20), BRICK_STATE(0x4640), BRICK_STATE(0xC600),
+    BRICK_STATE(0x6C00) },
+  // 'Rotated by 180 degrees'
+  { BRICK_STATE(0x2222), BRICK_STATE(0x0660), BRICK_STATE(0x4460),
+    BRICK_STATE(0x44C0), BRICK_STATE(0x0E40), BRICK_STATE(0x2640),
+    BRICK_STATE(0x4620) },
+  // 'Rotated by 270 degrees'
+  { BRICK_STATE(0x00F0), BRICK_STATE(0x0660), BRICK_STATE(0x0E80),
+    BRICK_STATE(0x8E00), BRICK_STATE(0x4C40), BRICK_STATE(0x0C60),
+    BRICK_STATE(0x06C0) }
+};
+// Scoring and gravity tables (see global.h).
+const uint16_t TETRIS_LINE_SCORES[5] = { 0, 40, 100, 300, 1200 };
+const uint32_t TETRIS_GRAVITY[TETRIS_GRAVITY_LEVELS] = {
+  TETRIS_G_FRAMES(48), TETRIS_G_FRAMES(43), TETRIS_G_FRAMES(38),
+  TETRIS_G_FRAMES(33), TETRIS_G_FRAMES(28), TETRIS_G_FRAMES(23),
+  TETRIS_G_FRAMES(18), TETRIS_G_FRAMES(13), TETRIS_G_FRAMES(8),
+  TETRIS_G_FRAMES(6),  TETRIS_G_FRAMES(5),  TETRIS_G_FRAMES(5),
+  TETRIS_G_FRAMES(5),  TETRIS_G_FRAMES(4),  TETRIS_G_FRAMES(4),
+  TETRIS_G_FRAMES(4),  TETRIS_G_FRAMES(3),  TETRIS_G_FRAMES(3),
+  TETRIS_G_FRAMES(3),  TETRIS_G_FRAMES(2),  (20 * TETRIS_G_ONE)
+};
+
 // C-language utility method definitions.
 /*
  * Send a series of startup commands over I2C.
@@ -47,54 +157,331 @@ void ssd1306_start_sequence(I2C_TypeDef *I2Cx) {
 }
 
 /*
- * Draw a horizontal line.
- * First, calculate the Y bitmask and byte offset, then just go from x->x.
+ * Present the finished 'back' framebuffer.
+ * This waits for the previous update to finish, swaps the front
+ * and back buffers, and starts sending the new front buffer's
+ * dirty regions. The same regions are then copied into the new
+ * back buffer, so that it matches what is on the screen and the
+ * next frame can be drawn on top of it while this one is sent.
  */
-inline void oled_draw_h_line(int x, int y,
-                             int w, unsigned char color) {
-  int y_page_offset = y / 8;
-  y_page_offset *= 128;
-  int bit_to_set = 0x01 << (y & 0x07);
-  if (!color) {
-    bit_to_set = ~bit_to_set;
+void oled_present(I2C_TypeDef *I2Cx) {
+  while (oled_fb_dma_state != OLED_FB_DMA_IDLE) {}
+  unsigned char *last_front = oled_fb_front;
+  oled_fb_front = oled_fb;
+  oled_fb = last_front;
+  ssd1306_update(I2Cx);
+  uint8_t page;
+  uint16_t offset;
+  uint16_t x_pos;
+  for (page = 0; page < OLED_PAGES; ++page) {
+    if (oled_update_x0[page] > oled_update_x1[page]) { continue; }
+    offset = page * 128;
+    for (x_pos = oled_update_x0[page];
+         x_pos <= oled_update_x1[page]; ++x_pos) {
+      oled_fb[offset + x_pos] = oled_fb_front[offset + x_pos];
+    }
+  }
+}
+
+/*
+ * Start a DMA-driven update of the display's dirty regions,
+ * from the 'front' framebuffer.
+ * The dirty regions are copied into the 'update' window list
+ * and reset, and the update runs from the I2C interrupts.
+ * Runs of full-width pages are merged into one window, so a
+ * full-screen update is still a single 1025-byte transfer.
+ */
+void ssd1306_update(I2C_TypeDef *I2Cx) {
+  uint8_t page;
+  latency_frame_sending();
+  oled_update_last_page = OLED_PAGES;
+  for (page = 0; page < OLED_PAGES; ++page) {
+    oled_update_x0[page] = oled_dirty_x0[page];
+    oled_update_x1[page] = oled_dirty_x1[page];
+    if (oled_dirty_x0[page] <= oled_dirty_x1[page]) {
+      oled_update_last_page = page;
+    }
+  }
+  oled_clear_dirty();
+  if (oled_update_last_page == OLED_PAGES) {
+    // Nothing to send.
+    oled_fb_dma_state = OLED_FB_DMA_IDLE;
+    latency_frame_shown();
+    return;
+  }
+  oled_fb_dma_state = OLED_FB_DMA_SENDING;
+  oled_update_page = 0;
+  oled_update_phase = OLED_UPDATE_PHASE_CMD;
+  ssd1306_update_next(I2Cx);
+}
+
+/*
+ * Start the next transfer in a display update.
+ * This is called from the I2C interrupt handler when the
+ * previous transfer finishes. Each dirty window is sent as
+ * an addressing command followed by the window's data.
+ */
+void ssd1306_update_next(I2C_TypeDef *I2Cx) {
+  uint8_t page = oled_update_page;
+  if (oled_update_phase == OLED_UPDATE_PHASE_DATA) {
+    // Send the window's data. Consecutive full-width pages
+    // are contiguous in the framebuffer.
+    uint8_t x0 = oled_update_x0[page];
+    uint8_t x1 = oled_update_x1[page];
+    uint8_t last_page = oled_update_cmd[5];
+    oled_update_page = last_page + 1;
+    oled_update_phase = OLED_UPDATE_PHASE_CMD;
+    i2c_dma_write(I2Cx, I2C1_TX_DMA_CHANNEL, 0x40,
+                  &oled_fb_front[(page * 128) + x0],
+                  ((last_page - page) * 128) + (x1 - x0) + 1);
+    return;
+  }
+  // Find the next dirty page.
+  while (page < OLED_PAGES &&
+         oled_update_x0[page] > oled_update_x1[page]) {
+    ++page;
+  }
+  if (page >= OLED_PAGES) {
+    // Done; the last data transfer has finished.
+    oled_fb_dma_state = OLED_FB_DMA_IDLE;
+    latency_frame_shown();
+    return;
+  }
+  uint8_t last_page = page;
+  if (oled_update_x0[page] == 0 && oled_update_x1[page] == 127) {
+    while (last_page + 1 < OLED_PAGES &&
+           oled_update_x0[last_page + 1] == 0 &&
+           oled_update_x1[last_page + 1] == 127) {
+      ++last_page;
+    }
+  }
+  oled_update_page = page;
+  oled_update_phase = OLED_UPDATE_PHASE_DATA;
+  // Set column address range.
+  oled_update_cmd[0] = 0x21;
+  oled_update_cmd[1] = oled_update_x0[page];
+  oled_update_cmd[2] = oled_update_x1[page];
+  // Set page address range.
+  oled_update_cmd[3] = 0x22;
+  oled_update_cmd[4] = page;
+  oled_update_cmd[5] = last_page;
+  i2c_dma_write(I2Cx, I2C1_TX_DMA_CHANNEL, 0x00,
+                oled_update_cmd, 6);
+}
+
+/*
+ * Mark a rectangle of the framebuffer as 'dirty', so that it
+ * gets sent in the next display update.
+ */
+void oled_mark_dirty(int x, int y, int w, int h) {
+  if (w <= 0 || h <= 0) { return; }
+  int x1 = x + w - 1;
+  int y1 = y + h - 1;
+  if (x < 0) { x = 0; }
+  if (y < 0) { y = 0; }
+  if (x1 > 127) { x1 = 127; }
+  if (y1 > 63) { y1 = 63; }
+  if (x > x1 || y > y1) { return; }
+  int page;
+  for (page = (y >> 3); page <= (y1 >> 3); ++page) {
+    if (x < oled_dirty_x0[page]) {
+      oled_dirty_x0[page] = x;
+    }
+    if (x1 > oled_dirty_x1[page]) {
+      oled_dirty_x1[page] = x1;
+    }
+  }
+}
+
+/*
+ * Mark the whole framebuffer as 'dirty'.
+ */
+void oled_mark_all_dirty(void) {
+  uint8_t page;
+  for (page = 0; page < OLED_PAGES; ++page) {
+    oled_dirty_x0[page] = 0;
+    oled_dirty_x1[page] = 127;
   }
+}
+
+/*
+ * Reset the dirty regions; nothing needs to be sent.
+ */
+void oled_clear_dirty(void) {
+  uint8_t page;
+  for (page = 0; page < OLED_PAGES; ++page) {
+    oled_dirty_x0[page] = OLED_DIRTY_CLEAN_X0;
+    oled_dirty_x1[page] = OLED_DIRTY_CLEAN_X1;
+  }
+}
+
+/*
+ * Fill a whole framebuffer-sized buffer with one byte value.
+ * The buffers are word-aligned, so this writes 4 words per
+ * loop iteration.
+ */
+void fb_fill(unsigned char *fb, unsigned char value) {
+  uint32_t fill = value * 0x01010101;
+  uint32_t *pw = (uint32_t*)fb;
+  uint32_t *pw_end = (uint32_t*)(fb + OLED_FB_SIZE);
+  while (pw < pw_end) {
+    pw[0] = fill;
+    pw[1] = fill;
+    pw[2] = fill;
+    pw[3] = fill;
+    pw += 4;
+  }
+}
+
+/*
+ * Clear a whole framebuffer-sized buffer.
+ */
+void fb_clear(unsigned char *fb) {
+  fb_fill(fb, 0x00);
+}
+
+/*
+ * Copy one framebuffer-sized buffer to another, 4 words
+ * per loop iteration.
+ */
+void fb_copy(unsigned char *dst, const unsigned char *src) {
+  uint32_t *pd = (uint32_t*)dst;
+  const uint32_t *ps = (const uint32_t*)src;
+  uint32_t *pd_end = (uint32_t*)(dst + OLED_FB_SIZE);
+  while (pd < pd_end) {
+    pd[0] = ps[0];
+    pd[1] = ps[1];
+    pd[2] = ps[2];
+    pd[3] = ps[3];
+    pd += 4;
+    ps += 4;
+  }
+}
+
+/*
+ * Start a screen from its background layer.
+ * If the background slot doesn't hold 'screen', it is cleared
+ * and re-rendered by calling 'render', which draws the static
+ * parts of that screen into the framebuffer. Otherwise, the
+ * cached background is copied into the framebuffer.
+ */
+void oled_bg_show(uint8_t screen, void (*render)(void)) {
+  if (oled_bg_screen == screen) {
+    fb_copy(oled_fb, oled_bg);
+  }
+  else {
+    fb_clear(oled_fb);
+    render();
+    fb_copy(oled_bg, oled_fb);
+    oled_bg_screen = screen;
+  }
+  oled_mark_all_dirty();
+}
+
+/*
+ * Restore a rectangle of the framebuffer from the background
+ * layer, to erase whatever was drawn on top of it.
+ * The rectangle is clipped to the screen.
+ */
+void oled_bg_restore(int x, int y, int w, int h) {
+  int x1 = x + w;
+  int y1 = y + h;
+  if (x < 0) { x = 0; }
+  if (y < 0) { y = 0; }
+  if (x1 > 128) { x1 = 128; }
+  if (y1 > 64) { y1 = 64; }
+  if (x >= x1 || y >= y1) { return; }
+  oled_mark_dirty(x, y, x1 - x, y1 - y);
+  int page;
   int x_pos;
-  for (x_pos = x; x_pos < (x+w); ++x_pos) {
-    if (color) {
-      oled_fb[x_pos + y_page_offset] |= bit_to_set;
+  for (page = (y >> 3); page <= ((y1 - 1) >> 3); ++page) {
+    int row0 = (page == (y >> 3)) ? (y & 0x07) : 0;
+    int row1 = (page == ((y1 - 1) >> 3)) ? ((y1 - 1) & 0x07) : 7;
+    uint8_t mask = (uint8_t)((0xFF << row0) & (0xFF >> (7 - row1)));
+    int offset = page * 128;
+    for (x_pos = x; x_pos < x1; ++x_pos) {
+      oled_fb[offset + x_pos] = ((oled_fb[offset + x_pos] & ~mask) |
+                                 (oled_bg[offset + x_pos] & mask));
+    }
+  }
+}
+
+/*
+ * Fill a rectangular span of the framebuffer.
+ * Each page is handled once: the rows that the span covers
+ * within that page are combined into one byte mask, which is
+ * repeated across a 32-bit word so that the aligned middle of
+ * the span can be written 4 columns at a time. Pages which are
+ * fully covered are written with plain stores, with no
+ * read-modify-write. The span is clipped to the screen.
+ */
+void oled_fill_span(int x, int y, int w, int h, unsigned char color) {
+  int x1 = x + w;
+  int y1 = y + h;
+  if (x < 0) { x = 0; }
+  if (y < 0) { y = 0; }
+  if (x1 > 128) { x1 = 128; }
+  if (y1 > 64) { y1 = 64; }
+  if (x >= x1 || y >= y1) { return; }
+  oled_mark_dirty(x, y, x1 - x, y1 - y);
+  int page;
+  for (page = (y >> 3); page <= ((y1 - 1) >> 3); ++page) {
+    // Combine the rows in this page into one mask.
+    int row0 = (page == (y >> 3)) ? (y & 0x07) : 0;
+    int row1 = (page == ((y1 - 1) >> 3)) ? ((y1 - 1) & 0x07) : 7;
+    uint8_t mask = (uint8_t)((0xFF << row0) & (0xFF >> (7 - row1)));
+    uint32_t mask_w = mask * 0x01010101;
+    unsigned char *p = &oled_fb[(page * 128) + x];
+    unsigned char *p_end = &oled_fb[(page * 128) + x1];
+    // Leading bytes, up to a word boundary.
+    while (p < p_end && ((uintptr_t)p & 0x03)) {
+      if (color) { *p |= mask; }
+      else { *p &= ~mask; }
+      ++p;
+    }
+    // Whole words.
+    uint32_t *pw = (uint32_t*)p;
+    uint32_t *pw_end = (uint32_t*)((uintptr_t)p_end & ~0x03);
+    if (mask == 0xFF) {
+      uint32_t fill = color ? 0xFFFFFFFF : 0x00000000;
+      while (pw < pw_end) { *pw++ = fill; }
+    }
+    else if (color) {
+      while (pw < pw_end) { *pw++ |= mask_w; }
     }
     else {
-      oled_fb[x_pos + y_page_offset] &= bit_to_set;
+      while (pw < pw_end) { *pw++ &= ~mask_w; }
+    }
+    // Trailing bytes.
+    p = (unsigned char*)pw;
+    while (p < p_end) {
+      if (color) { *p |= mask; }
+      else { *p &= ~mask; }
+      ++p;
     }
   }
 }
 
+/*
+ * Draw a horizontal line.
+ */
+inline void oled_draw_h_line(int x, int y,
+                             int w, unsigned char color) {
+  oled_fill_span(x, y, w, 1, color);
+}
+
 /*
  * Draw a veritcal line.
  */
 inline void oled_draw_v_line(int x, int y,
                              int h, unsigned char color) {
-  int y_page_offset;
-  int bit_to_set;
-  int y_pos;
-  for (y_pos = y; y_pos < (y+h); ++y_pos) {
-    y_page_offset = y_pos/8;
-    y_page_offset *= 128;
-    bit_to_set = 0x01 << (y_pos & 0x07);
-    if (color) {
-      oled_fb[x + y_page_offset] |= bit_to_set;
-    }
-    else {
-      bit_to_set = ~bit_to_set;
-      oled_fb[x + y_page_offset] &= bit_to_set;
-    }
-  }
+  oled_fill_span(x, y, 1, h, color);
 }
 
 /*
  * Draw a rectangle on the display.
- * I guess just pick the longer dimension, and either draw
- * horizontal or vertical lines.
+ * Filled rectangles and each side of an outline are drawn
+ * as a single span fill.
  * Notable args:
  *   - outline: If <=0, fill the rectangle with 'color'.
  *        If >0, draw an outline inside the dimensions of N pixels.
@@ -104,40 +491,18 @@ inline void oled_draw_rect(int x, int y, int w, int h,
                            int outline, unsigned char color) {
   if (outline > 0) {
     // Draw an outline.
-    int o_pos;
     // Top.
-    for (o_pos = y; o_pos < (y+outline); ++o_pos) {
-      oled_draw_h_line(x, o_pos, w, color);
-    }
+    oled_fill_span(x, y, w, outline, color);
     // Bottom.
-    for (o_pos = (y+h-1); o_pos > (y+h-1-outline); --o_pos) {
-      oled_draw_h_line(x, o_pos, w, color);
-    }
+    oled_fill_span(x, (y+h-outline), w, outline, color);
     // Left.
-    for (o_pos = x; o_pos < (x+outline); ++o_pos) {
-      oled_draw_v_line(o_pos, y, h, color);
-    }
+    oled_fill_span(x, y, outline, h, color);
     // Right.
-    for (o_pos = (x+w-1); o_pos > (x+w-1-outline); --o_pos) {
-      oled_draw_v_line(o_pos, y, h, color);
-    }
+    oled_fill_span((x+w-outline), y, outline, h, color);
   }
   else {
     // Draw a filled rectangle.
-    if (w > h) {
-      // Draw fewer horizontal lines than vertical ones.
-      int y_pos;
-      for (y_pos = y; y_pos < (y+h); ++y_pos) {
-        oled_draw_h_line(x, y_pos, w, color);
-      }
-    }
-    else {
-      // Draw fewer (or ==) vertical lines than horizontal ones.
-      int x_pos;
-      for (x_pos = x; x_pos < (x+w); ++x_pos) {
-        oled_draw_v_line(x_pos, y, h, color);
-      }
-    }
+    oled_fill_span(x, y, w, h, color);
   }
 }
 
@@ -155,6 +520,7 @@ inline void oled_write_pixel(int x, int y, unsigned char color) {
   int y_page = y / 8;
   int byte_to_mod = x + (y_page * 128);
   int bit_to_set = 0x01 << (y & 0x07);
+  oled_mark_dirty(x, y, 1, 1);
   if (color) {
     oled_fb[byte_to_mod] |= bit_to_set;
   }
@@ -164,402 +530,180 @@ inline void oled_write_pixel(int x, int y, unsigned char color) {
   }
 }
 
-void oled_draw_letter(int x, int y, unsigned int w0, unsigned int w1, unsigned char color, char size) {
-  // TODO: Make this more efficient than drawing
-  // pixels one-by-one.
-  int w_iter = 0;
-  int cur_x = x;
-  int cur_y = y;
-  unsigned int aw0 = w0;
-  unsigned int aw1 = w1;
-  if (!color) {
-    aw0 = ~aw0;
-    aw1 = ~aw1;
-  }
-  int px_incr = 1;
-  int line_h = 8;
-  unsigned char t_col = 0x00;
-  int cx = cur_x;
-  int cy = cur_y;
-  if (size == 'L') {
-    px_incr = 2;
-    line_h = 16;
-  }
-  for (w_iter = 31; w_iter >= 0; --w_iter) {
-    t_col = !(!(aw0 & (1 << w_iter)));
-    for (cx = cur_x; cx < cur_x + px_incr; ++cx) {
-      for (cy = cur_y; cy < cur_y + px_incr; ++cy) {
-        oled_write_pixel(cx, cy, t_col);
-      }
-    }
-    cur_y += px_incr;
-    if (cur_y == y+line_h) {
-      cur_y = y;
-      cur_x += px_incr;
+/*
+ * Find the glyph for an ASCII character in the font table.
+ * Characters outside of the table's range are drawn blank.
+ */
+const uint8_t *oled_glyph(char c) {
+  if (c < OLED_FONT_FIRST || c > OLED_FONT_LAST) {
+    c = ' ';
+  }
+  return OLED_FONT[c - OLED_FONT_FIRST];
+}
+
+/*
+ * Write one column of up to 16 pixels, opaquely, starting at
+ * (x, y). Bit 0 of 'bits' is the top pixel. The column is
+ * shifted into place and split across the pages that it
+ * overlaps, so each page byte is written once.
+ * This doesn't mark anything as dirty; callers do that for
+ * the whole area that they draw.
+ */
+static void oled_blit_column(int x, int y, uint32_t bits, int h) {
+  uint32_t mask = (1 << h) - 1;
+  if (x < 0 || x > 127 || y >= 64) { return; }
+  if (y < 0) {
+    if (-y >= h) { return; }
+    bits >>= -y;
+    mask >>= -y;
+    y = 0;
+  }
+  bits = (bits << (y & 0x07)) & (mask << (y & 0x07));
+  mask <<= (y & 0x07);
+  unsigned char *p = &oled_fb[((y >> 3) * 128) + x];
+  unsigned char *p_end = &oled_fb[OLED_FB_SIZE];
+  while (mask && p < p_end) {
+    *p = (*p & ~mask) | bits;
+    mask >>= 8;
+    bits >>= 8;
+    p += 128;
+  }
+}
+
+/*
+ * Write a strip of 'w' columns of up to 16 pixels, opaquely,
+ * starting at (x, y). The page split is the same for every
+ * column, so this walks the (up to 3) pages that the strip
+ * overlaps and writes a run of bytes in each one.
+ * Like 'oled_blit_column', this doesn't mark anything as dirty.
+ */
+static void oled_blit_strip(int x, int y, const uint16_t *cols, int w, int h) {
+  int c0 = (x < 0) ? -x : 0;
+  int c1 = ((x + w) > 128) ? (128 - x) : w;
+  if (c0 >= c1 || y >= 64 || y <= -h) { return; }
+  int shift = y & 0x07;
+  int page = y >> 3;
+  uint32_t mask = ((1 << h) - 1) << shift;
+  int k;
+  int i;
+  for (k = 0; k < 3; ++k, ++page) {
+    uint8_t m = (mask >> (k * 8)) & 0xFF;
+    if (!m) { break; }
+    if (page < 0 || page >= OLED_PAGES) { continue; }
+    unsigned char *p = &oled_fb[(page * 128) + x];
+    for (i = c0; i < c1; ++i) {
+      p[i] = (p[i] & ~m) | ((((uint32_t)cols[i] << shift) >> (k * 8)) & m);
     }
   }
-  for (w_iter = 15; w_iter >= 0; --w_iter) {
-    t_col = !(!(aw1 & (1 << w_iter)));
-    for (cx = cur_x; cx < cur_x + px_incr; ++cx) {
-      for (cy = cur_y; cy < cur_y + px_incr; ++cy) {
-        oled_write_pixel(cx, cy, t_col);
-      }
+}
+
+/*
+ * Draw a glyph of 6 column bytes, with the top pixel in bit 0.
+ * Glyphs are opaque; unset pixels are drawn as '!color'.
+ * Each column is written as a whole byte, or as a 16-pixel
+ * column for size 'L', which draws each pixel as a 2x2 square.
+ */
+void oled_draw_glyph(int x, int y, const uint8_t *cols, unsigned char color, char size) {
+  int col;
+  uint8_t col_bits;
+  if (size == 'L') {
+    oled_mark_dirty(x, y, OLED_GLYPH_W * 2, 16);
+    for (col = 0; col < OLED_GLYPH_W; ++col) {
+      col_bits = color ? cols[col] : ~cols[col];
+      uint32_t col_l = OLED_SCALE2(col_bits);
+      oled_blit_column(x + (col * 2), y, col_l, 16);
+      oled_blit_column(x + (col * 2) + 1, y, col_l, 16);
     }
-    cur_y += px_incr;
-    if (cur_y == y+line_h) {
-      cur_y = y;
-      cur_x += px_incr;
+  }
+  else {
+    oled_mark_dirty(x, y, OLED_GLYPH_W, 8);
+    for (col = 0; col < OLED_GLYPH_W; ++col) {
+      col_bits = color ? cols[col] : ~cols[col];
+      oled_blit_column(x + col, y, col_bits, 8);
     }
   }
 }
 
+/*
+ * Draw a glyph given as packed 'OLED_CH_*'-style words:
+ * 'w0' holds the first 4 columns and the low 16 bits of 'w1'
+ * hold the last 2, with the top pixel in each byte's MSB.
+ */
+void oled_draw_letter(int x, int y, unsigned int w0, unsigned int w1, unsigned char color, char size) {
+  const uint8_t cols[OLED_GLYPH_W] = OLED_GLYPH(w0, w1);
+  oled_draw_glyph(x, y, cols, color, size);
+}
+
 void oled_draw_letter_c(int x, int y, char c, unsigned char color, char size) {
-  unsigned int w0 = 0x00;
-  unsigned int w1 = 0x00;
-  if (c == 'A') {
-    w0 = OLED_CH_A0;
-    w1 = OLED_CH_A1B1 >> 16;
-  }
-  else if (c == 'B') {
-    w0 = OLED_CH_B0;
-    w1 = OLED_CH_A1B1 & 0x0000FFFF;
-  }
-  else if (c == 'C') {
-    w0 = OLED_CH_C0;
-    w1 = OLED_CH_C1D1 >> 16;
-  }
-  else if (c == 'D') {
-    w0 = OLED_CH_D0;
-    w1 = OLED_CH_C1D1 & 0x0000FFFF;
-  }
-  else if (c == 'E') {
-    w0 = OLED_CH_E0;
-    w1 = OLED_CH_E1F1 >> 16;
-  }
-  else if (c == 'F') {
-    w0 = OLED_CH_F0;
-    w1 = OLED_CH_E1F1 & 0x0000FFFF;
-  }
-  else if (c == 'G') {
-    w0 = OLED_CH_G0;
-    w1 = OLED_CH_G1H1 >> 16;
-  }
-  else if (c == 'H') {
-    w0 = OLED_CH_H0;
-    w1 = OLED_CH_G1H1 & 0x0000FFFF;
-  }
-  else if (c == 'I') {
-    w0 = OLED_CH_I0;
-    w1 = OLED_CH_I1J1 >> 16;
-  }
-  else if (c == 'J') {
-    w0 = OLED_CH_J0;
-    w1 = OLED_CH_I1J1 & 0x0000FFFF;
-  }
-  else if (c == 'K') {
-    w0 = OLED_CH_K0;
-    w1 = OLED_CH_K1L1 >> 16;
-  }
-  else if (c == 'L') {
-    w0 = OLED_CH_L0;
-    w1 = OLED_CH_K1L1 & 0x0000FFFF;
-  }
-  else if (c == 'M') {
-    w0 = OLED_CH_M0;
-    w1 = OLED_CH_M1N1 >> 16;
-  }
-  else if (c == 'N') {
-    w0 = OLED_CH_N0;
-    w1 = OLED_CH_M1N1 & 0x0000FFFF;
-  }
-  else if (c == 'O') {
-    w0 = OLED_CH_O0;
-    w1 = OLED_CH_O1P1 >> 16;
-  }
-  else if (c == 'P') {
-    w0 = OLED_CH_P0;
-    w1 = OLED_CH_O1P1 & 0x0000FFFF;
-  }
-  else if (c == 'Q') {
-    w0 = OLED_CH_Q0;
-    w1 = OLED_CH_Q1R1 >> 16;
-  }
-  else if (c == 'R') {
-    w0 = OLED_CH_R0;
-    w1 = OLED_CH_Q1R1 & 0x0000FFFF;
-  }
-  else if (c == 'S') {
-    w0 = OLED_CH_S0;
-    w1 = OLED_CH_S1T1 >> 16;
-  }
-  else if (c == 'T') {
-    w0 = OLED_CH_T0;
-    w1 = OLED_CH_S1T1 & 0x0000FFFF;
-  }
-  else if (c == 'U') {
-    w0 = OLED_CH_U0;
-    w1 = OLED_CH_U1V1 >> 16;
-  }
-  else if (c == 'V') {
-    w0 = OLED_CH_V0;
-    w1 = OLED_CH_U1V1 & 0x0000FFFF;
-  }
-  else if (c == 'W') {
-    w0 = OLED_CH_W0;
-    w1 = OLED_CH_W1X1 >> 16;
-  }
-  else if (c == 'X') {
-    w0 = OLED_CH_X0;
-    w1 = OLED_CH_W1X1 & 0x0000FFFF;
-  }
-  else if (c == 'Y') {
-    w0 = OLED_CH_Y0;
-    w1 = OLED_CH_Y1Z1 >> 16;
-  }
-  else if (c == 'Z') {
-    w0 = OLED_CH_Z0;
-    w1 = OLED_CH_Y1Z1 & 0x0000FFFF;
-  }
-  else if (c == 'a') {
-    w0 = OLED_CH_a0;
-    w1 = OLED_CH_a1b1 >> 16;
-  }
-  else if (c == 'b') {
-    w0 = OLED_CH_b0;
-    w1 = OLED_CH_a1b1 & 0x0000FFFF;
-  }
-  else if (c == 'c') {
-    w0 = OLED_CH_c0;
-    w1 = OLED_CH_c1d1 >> 16;
-  }
-  else if (c == 'd') {
-    w0 = OLED_CH_d0;
-    w1 = OLED_CH_c1d1 & 0x0000FFFF;
-  }
-  else if (c == 'e') {
-    w0 = OLED_CH_e0;
-    w1 = OLED_CH_e1f1 >> 16;
-  }
-  else if (c == 'f') {
-    w0 = OLED_CH_f0;
-    w1 = OLED_CH_e1f1 & 0x0000FFFF;
-  }
-  else if (c == 'g') {
-    w0 = OLED_CH_g0;
-    w1 = OLED_CH_g1h1 >> 16;
-  }
-  else if (c == 'h') {
-    w0 = OLED_CH_h0;
-    w1 = OLED_CH_g1h1 & 0x0000FFFF;
-  }
-  else if (c == 'i') {
-    w0 = OLED_CH_i0;
-    w1 = OLED_CH_i1j1 >> 16;
-  }
-  else if (c == 'j') {
-    w0 = OLED_CH_j0;
-    w1 = OLED_CH_i1j1 & 0x0000FFFF;
-  }
-  else if (c == 'k') {
-    w0 = OLED_CH_k0;
-    w1 = OLED_CH_k1l1 >> 16;
-  }
-  else if (c == 'l') {
-    w0 = OLED_CH_l0;
-    w1 = OLED_CH_k1l1 & 0x0000FFFF;
-  }
-  else if (c == 'm') {
-    w0 = OLED_CH_m0;
-    w1 = OLED_CH_m1n1 >> 16;
-  }
-  else if (c == 'n') {
-    w0 = OLED_CH_n0;
-    w1 = OLED_CH_m1n1 & 0x0000FFFF;
-  }
-  else if (c == 'o') {
-    w0 = OLED_CH_o0;
-    w1 = OLED_CH_o1p1 >> 16;
-  }
-  else if (c == 'p') {
-    w0 = OLED_CH_p0;
-    w1 = OLED_CH_o1p1 & 0x0000FFFF;
-  }
-  else if (c == 'q') {
-    w0 = OLED_CH_q0;
-    w1 = OLED_CH_q1r1 >> 16;
-  }
-  else if (c == 'r') {
-    w0 = OLED_CH_r0;
-    w1 = OLED_CH_q1r1 & 0x0000FFFF;
-  }
-  else if (c == 's') {
-    w0 = OLED_CH_s0;
-    w1 = OLED_CH_s1t1 >> 16;
-  }
-  else if (c == 't') {
-    w0 = OLED_CH_t0;
-    w1 = OLED_CH_s1t1 & 0x0000FFFF;
-  }
-  else if (c == 'u') {
-    w0 = OLED_CH_u0;
-    w1 = OLED_CH_u1v1 >> 16;
-  }
-  else if (c == 'v') {
-    w0 = OLED_CH_v0;
-    w1 = OLED_CH_u1v1 & 0x0000FFFF;
-  }
-  else if (c == 'w') {
-    w0 = OLED_CH_w0;
-    w1 = OLED_CH_w1x1 >> 16;
-  }
-  else if (c == 'x') {
-    w0 = OLED_CH_x0;
-    w1 = OLED_CH_w1x1 & 0x0000FFFF;
-  }
-  else if (c == 'y') {
-    w0 = OLED_CH_y0;
-    w1 = OLED_CH_y1z1 >> 16;
-  }
-  else if (c == 'z') {
-    w0 = OLED_CH_z0;
-    w1 = OLED_CH_y1z1 & 0x0000FFFF;
-  }
-  else if (c == '0') {
-    w0 = OLED_CH_00;
-    w1 = OLED_CH_0111 >> 16;
-  }
-  else if (c == '1') {
-    w0 = OLED_CH_10;
-    w1 = OLED_CH_0111 & 0x0000FFFF;
-  }
-  else if (c == '2') {
-    w0 = OLED_CH_20;
-    w1 = OLED_CH_2131 >> 16;
-  }
-  else if (c == '3') {
-    w0 = OLED_CH_30;
-    w1 = OLED_CH_2131 & 0x0000FFFF;
-  }
-  else if (c == '4') {
-    w0 = OLED_CH_40;
-    w1 = OLED_CH_4151 >> 16;
-  }
-  else if (c == '5') {
-    w0 = OLED_CH_50;
-    w1 = OLED_CH_4151 & 0x0000FFFF;
-  }
-  else if (c == '6') {
-    w0 = OLED_CH_60;
-    w1 = OLED_CH_6171 >> 16;
-  }
-  else if (c == '7') {
-    w0 = OLED_CH_70;
-    w1 = OLED_CH_6171 & 0x0000FFFF;
-  }
-  else if (c == '8') {
-    w0 = OLED_CH_80;
-    w1 = OLED_CH_8191 >> 16;
-  }
-  else if (c == '9') {
-    w0 = OLED_CH_90;
-    w1 = OLED_CH_8191 & 0x0000FFFF;
-  }
-  else if (c == ':') {
-    w0 = OLED_CH_col0;
-    w1 = OLED_CH_col1per1 >> 16;
-  }
-  else if (c == '.') {
-    w0 = OLED_CH_per0;
-    w1 = OLED_CH_col1per1 & 0x0000FFFF;
-  }
-  else if (c == '!') {
-    w0 = OLED_CH_exc0;
-    w1 = OLED_CH_exc1fws1 >> 16;
-  }
-  else if (c == '/') {
-    w0 = OLED_CH_fws0;
-    w1 = OLED_CH_exc1fws1 & 0x0000FFFF;
-  }
-  else if (c == '-') {
-    w0 = OLED_CH_hyp0;
-    w1 = OLED_CH_hyp1pls1 >> 16;
-  }
-  else if (c == '+') {
-    w0 = OLED_CH_pls0;
-    w1 = OLED_CH_hyp1pls1 & 0x0000FFFF;
+  oled_draw_glyph(x, y, oled_glyph(c), color, size);
+}
+
+// Powers of ten, for 'oled_format_int'.
+static const uint32_t POW10[10] = {
+  1000000000, 100000000, 10000000, 1000000, 100000,
+  10000, 1000, 100, 10, 1
+};
+
+/*
+ * Format an integer as decimal text, right-aligned in a field
+ * of at least 'width' characters which is padded with 'pad'.
+ * The Cortex-M0 has no divide instruction, so each digit is
+ * found by subtracting its power of ten until it underflows,
+ * instead of dividing; that is at most 9 subtractions per digit.
+ * 'buf' must hold at least max(width, 11) + 1 characters.
+ * Returns the length of the formatted text.
+ */
+int oled_format_int(char *buf, int val, uint8_t width, char pad) {
+  char digits[11];
+  int len = 0;
+  int i = 0;
+  uint32_t uval = (uint32_t)val;
+  if (val < 0) {
+    uval = 0 - uval;
+  }
+  // Skip leading zeros; the last digit is always drawn.
+  uint8_t p = 0;
+  while (p < 9 && uval < POW10[p]) { ++p; }
+  for (; p < 10; ++p) {
+    char d = '0';
+    while (uval >= POW10[p]) {
+      uval -= POW10[p];
+      ++d;
+    }
+    digits[len++] = d;
   }
-  else if (c == '<') {
-    w0 = OLED_CH_lct0;
-    w1 = OLED_CH_lct1rct1 >> 16;
+  int total = len + (val < 0);
+  // Zero-padding goes after the sign; space-padding before it.
+  if (pad != '0') {
+    for (; total < width; ++total) { buf[i++] = pad; }
   }
-  else if (c == '>') {
-    w0 = OLED_CH_rct0;
-    w1 = OLED_CH_lct1rct1 & 0x0000FFFF;
+  if (val < 0) { buf[i++] = '-'; }
+  if (pad == '0') {
+    for (; total < width; ++total) { buf[i++] = '0'; }
   }
-  oled_draw_letter(x, y, w0, w1, color, size);
+  int d;
+  for (d = 0; d < len; ++d) { buf[i++] = digits[d]; }
+  buf[i] = '\0';
+  return i;
 }
 
 void oled_draw_letter_i(int x, int y, int ic, unsigned char color, char size) {
-  int magnitude = 1000000000;
-  int cur_x = x;
-  int first_found = 0;
-  int proc_val = ic;
-  if (proc_val < 0) {
-    proc_val = proc_val * -1;
-    oled_draw_letter_c(cur_x, y, '-', color, size);
-    if (size == 'S') {
-      cur_x += 6;
-    }
-    else if (size == 'L') {
-      cur_x += 12;
-    }
-  }
-  for (magnitude = 1000000000; magnitude > 0; magnitude = magnitude / 10) {
-    int m_val = proc_val / magnitude;
-    proc_val -= (m_val * magnitude);
-    if (m_val > 0 || first_found || magnitude == 1) {
-      first_found = 1;
-      char mc = ' ';
-      if (m_val == 0) {
-        mc = '0';
-      }
-      else if (m_val == 1) {
-        mc = '1';
-      }
-      else if (m_val == 2) {
-        mc = '2';
-      }
-      else if (m_val == 3) {
-        mc = '3';
-      }
-      else if (m_val == 4) {
-        mc = '4';
-      }
-      else if (m_val == 5) {
-        mc = '5';
-      }
-      else if (m_val == 6) {
-        mc = '6';
-      }
-      else if (m_val == 7) {
-        mc = '7';
-      }
-      else if (m_val == 8) {
-        mc = '8';
-      }
-      else if (m_val == 9) {
-        mc = '9';
-      }
-      oled_draw_letter_c(cur_x, y, mc, color, size);
-      if (size == 'S') {
-        cur_x += 6;
-      }
-      else if (size == 'L') {
-        cur_x += 12;
-      }
-      if (cur_x >= 128) { return; }
-    }
+  oled_format_int(oled_line_buf, ic, 0, ' ');
+  oled_draw_text(x, y, oled_line_buf, color, size);
+}
+
+/*
+ * Draw an integer right-aligned in a fixed-width field of
+ * 'width' characters, padded with spaces. The glyphs are
+ * opaque, so this fully overwrites the previous value, which
+ * makes it suitable for counters that change every frame.
+ */
+void oled_draw_int_field(int x, int y, int ic, uint8_t width, unsigned char color, char size) {
+  if (width > (sizeof(oled_line_buf) - 1)) {
+    width = sizeof(oled_line_buf) - 1;
   }
+  oled_format_int(oled_line_buf, ic, width, ' ');
+  oled_draw_text(x, y, oled_line_buf, color, size);
 }
 
 void oled_draw_text(int x, int y, char* cc, unsigned char color, char size) {
@@ -577,40 +721,227 @@ void oled_draw_text(int x, int y, char* cc, unsigned char color, char size) {
   }
 }
 
-void draw_main_menu(void) {
-  oled_draw_rect(0, 0, 128, 64, 0, 0);
+/*
+ * Empty the text cache.
+ */
+void oled_text_cache_clear(void) {
+  uint8_t i;
+  for (i = 0; i < OLED_TEXT_CACHE_SLOTS; ++i) {
+    oled_text_cache[i].str = 0;
+  }
+  oled_text_cache_used = 0;
+}
+
+/*
+ * Drop any cached strips for a string. Call this if the
+ * contents of a cached string's buffer change.
+ */
+void oled_text_cache_invalidate(const char *cc) {
+  uint8_t i;
+  for (i = 0; i < OLED_TEXT_CACHE_SLOTS; ++i) {
+    if (oled_text_cache[i].str == cc) {
+      oled_text_cache[i].str = 0;
+    }
+  }
+}
+
+/*
+ * Draw a static string through the text cache.
+ * The first call rasterises the string into a free slot; later
+ * calls with the same string pointer, size and color only blit
+ * the cached columns. Strings which are too wide for the pool
+ * are drawn without the cache.
+ */
+void oled_draw_text_cached(int x, int y, const char *cc, unsigned char color, char size) {
+  oled_text_slot_t *slot = 0;
+  oled_text_slot_t *free_slot = 0;
+  int col_w = (size == 'L') ? 2 : 1;
+  int h = (size == 'L') ? 16 : 8;
+  int i;
+  for (i = 0; i < OLED_TEXT_CACHE_SLOTS; ++i) {
+    oled_text_slot_t *s = &oled_text_cache[i];
+    if (s->str == cc && s->size == size && s->color == color) {
+      slot = s;
+      break;
+    }
+    if (!s->str && !free_slot) { free_slot = s; }
+  }
+  if (!slot) {
+    int len = 0;
+    while (cc[len] != '\0') { ++len; }
+    int width = len * OLED_GLYPH_W * col_w;
+    if (width > OLED_TEXT_CACHE_COLS) {
+      oled_draw_text(x, y, (char*)cc, color, size);
+      return;
+    }
+    if (!free_slot || (oled_text_cache_used + width) > OLED_TEXT_CACHE_COLS) {
+      oled_text_cache_clear();
+      free_slot = &oled_text_cache[0];
+    }
+    // Rasterise the string into the end of the column pool.
+    slot = free_slot;
+    slot->str = cc;
+    slot->size = size;
+    slot->color = color;
+    slot->start = oled_text_cache_used;
+    slot->width = width;
+    uint16_t *dst = &oled_text_cache_cols[oled_text_cache_used];
+    oled_text_cache_used += width;
+    for (i = 0; i < len; ++i) {
+      const uint8_t *cols = oled_glyph(cc[i]);
+      int col;
+      for (col = 0; col < OLED_GLYPH_W; ++col) {
+        uint8_t col_bits = color ? cols[col] : ~cols[col];
+        if (size == 'L') {
+          *dst++ = OLED_SCALE2(col_bits);
+          *dst++ = OLED_SCALE2(col_bits);
+        }
+        else {
+          *dst++ = col_bits;
+        }
+      }
+    }
+  }
+  // Blit the cached columns.
+  oled_mark_dirty(x, y, slot->width, h);
+  oled_blit_strip(x, y, &oled_text_cache_cols[slot->start], slot->width, h);
+}
+
+/*
+ * Find a character's glyph in a proportional font.
+ * Characters outside of the font's range use its first glyph,
+ * which is a space in the generated fonts.
+ */
+static const font_glyph_t *font_glyph(const font_t *font, char c) {
+  if ((uint8_t)c < font->first || (uint8_t)c > font->last) {
+    c = font->first;
+  }
+  return &font->glyphs[(uint8_t)c - font->first];
+}
+
+/*
+ * Return the width in pixels of a string in a proportional font.
+ */
+int oled_text_width(const char *cc, const font_t *font) {
+  int w = 0;
+  while (*cc != '\0') {
+    w += font_glyph(font, *cc++)->advance;
+  }
+  return w;
+}
+
+/*
+ * Draw a string in a proportional font. Like the fixed-width
+ * text, this is opaque; the spacing after each glyph is drawn
+ * in '!color'. Fonts are at most 16 pixels tall, and larger
+ * sizes are separate fonts, so there is no scaling here.
+ * Returns the width of the drawn text.
+ */
+int oled_draw_text_font(int x, int y, const char *cc, const font_t *font, unsigned char color) {
+  int cur_x = x;
+  int col_bytes = (font->height > 8) ? 2 : 1;
+  uint32_t bg_bits = color ? 0 : ((1 << font->height) - 1);
+  while (*cc != '\0') {
+    const font_glyph_t *g = font_glyph(font, *cc++);
+    const uint8_t *d = &font->data[g->offset];
+    int col;
+    oled_mark_dirty(cur_x, y, g->advance, font->height);
+    for (col = 0; col < g->width; ++col) {
+      uint32_t bits = d[0];
+      if (col_bytes == 2) {
+        bits |= (d[1] << 8);
+      }
+      d += col_bytes;
+      oled_blit_column(cur_x + col, y, bits ^ bg_bits, font->height);
+    }
+    for (; col < g->advance; ++col) {
+      oled_blit_column(cur_x + col, y, bg_bits, font->height);
+    }
+    cur_x += g->advance;
+  }
+  return cur_x - x;
+}
+
+/*
+ * Draw an integer right-aligned in a field which is 'field_w'
+ * pixels wide, in a proportional font. The part of the field
+ * to the left of the number is cleared to '!color', so this
+ * fully overwrites the previous value.
+ */
+void oled_draw_int_field_font(int x, int y, int ic, int field_w, const font_t *font, unsigned char color) {
+  oled_format_int(oled_line_buf, ic, 0, ' ');
+  int w = oled_text_width(oled_line_buf, font);
+  if (w < field_w) {
+    oled_fill_span(x, y, field_w - w, font->height, !color);
+    x += field_w - w;
+  }
+  oled_draw_text_font(x, y, oled_line_buf, font, color);
+}
+
+/*
+ * Draw the current frame based on the game's state.
+ * Nothing is drawn if no events were applied since the last
+ * frame, since the game state can't have changed.
+ */
+void draw_frame(void) {
+  if (game_state_seq == drawn_state_seq) { return; }
+  drawn_state_seq = game_state_seq;
+  if (game_state == GAME_STATE_MAIN_MENU) {
+    draw_main_menu();
+  }
+  else if (game_state == GAME_STATE_IN_GAME) {
+    draw_tetris_game();
+  }
+  else if (game_state == GAME_STATE_PAUSED) {
+    // (TODO)
+  }
+  else if (game_state == GAME_STATE_GAME_OVER) {
+    draw_game_over();
+  }
+  else if (oled_drawn_screen != game_state) {
+    oled_drawn_screen = game_state;
+    fb_fill(oled_fb, 0xFF);
+    oled_mark_all_dirty();
+  }
+  latency_frame_drawn();
+}
+
+/*
+ * Draw the static parts of each screen into the framebuffer.
+ * These are rendered into the background layer once, and
+ * copied from there when the screen is shown again.
+ */
+static void render_main_menu_bg(void) {
   // Only use the middle 96 pixels, to make this easier
   // to transition to a color display.
   oled_draw_rect(15, 0, 96, 64, 2, 1);
   // Draw a big 'TETRIS' in the top-middle.
-  oled_draw_text(27, 12, "TETRIS\0", 1, 'L');
+  oled_draw_text_cached(27, 12, "TETRIS\0", 1, 'L');
   // Draw menu options.
   // (Currently just 'Start')
-  oled_draw_text(50, 40, "Start\0", 1, 'S');
+  oled_draw_text_cached(50, 40, "Start\0", 1, 'S');
   // Draw a little triangle next to it.
   oled_draw_v_line(40, 42, 5, 1);
   oled_draw_v_line(41, 43, 3, 1);
   oled_write_pixel(42, 44, 1);
 }
 
-void draw_game_over(void) {
-  oled_draw_rect(0, 0, 128, 64, 0, 0);
+static void render_game_over_bg(void) {
   // Only use the middle 96 pixels, to make this easier
   // to transition to a color display.
   oled_draw_rect(15, 0, 96, 64, 2, 1);
   // Draw a bit 'GAME OVER' label.
-  oled_draw_text(39, 12, "GAME\0", 1, 'L');
-  oled_draw_text(39, 36, "OVER\0", 1, 'L');
+  oled_draw_text_cached(39, 12, "GAME\0", 1, 'L');
+  oled_draw_text_cached(39, 36, "OVER\0", 1, 'L');
 }
 
-void draw_tetris_game(void) {
-  oled_draw_rect(0, 0, 128, 64, 0, 0);
+static void render_tetris_game_bg(void) {
+  uint8_t grid_ix;
+  uint8_t grid_iy;
   // Only use the middle 96 pixels, to make this easier
   // to transition to a color display.
   oled_draw_rect(15, 0, 96, 64, 2, 1);
   // Draw a test grid, 10x20 @3 square pixels.
-  uint8_t grid_ix = 0;
-  uint8_t grid_iy = 0;
   // Vertical 'column' lines.
   for (grid_ix = 0; grid_ix < 11; ++grid_ix) {
     oled_draw_v_line(47 + (grid_ix * 3), 2, 60, 1);
@@ -619,30 +950,548 @@ void draw_tetris_game(void) {
   for (grid_iy = 0; grid_iy < 21; ++grid_iy) {
     oled_draw_h_line(48, 2 + (grid_iy * 3), 30, 1);
   }
+  // Labels for the counters in the left-hand panel.
+  oled_draw_text_font(TETRIS_PANEL_X, 3, "Score", &FONT_6X8, 1);
+  oled_draw_text_font(TETRIS_PANEL_X, 22, "Lines", &FONT_6X8, 1);
+  oled_draw_text_font(TETRIS_PANEL_X, 41, "Level", &FONT_6X8, 1);
+}
 
-  // Draw the grid.
-  for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+void draw_main_menu(void) {
+  // The menu is static, so only draw it when it isn't
+  // already in the framebuffer.
+  if (oled_drawn_screen == GAME_STATE_MAIN_MENU) { return; }
+  oled_drawn_screen = GAME_STATE_MAIN_MENU;
+  oled_bg_show(GAME_STATE_MAIN_MENU, render_main_menu_bg);
+}
+
+void draw_game_over(void) {
+  // Like the menu, the 'game over' screen is static.
+  if (oled_drawn_screen == GAME_STATE_GAME_OVER) { return; }
+  oled_drawn_screen = GAME_STATE_GAME_OVER;
+  oled_bg_show(GAME_STATE_GAME_OVER, render_game_over_bg);
+}
+
+/*
+ * Draw the Tetris game.
+ * The border and grid lines come from the background layer
+ * when the game screen is first shown; after that, only the
+ * cells which changed since the last frame are redrawn, which
+ * keeps the dirty regions (and the I2C traffic) small.
+ * Emptied cells are erased by restoring the background.
+ */
+void draw_tetris_game(void) {
+  uint8_t grid_ix = 0;
+  uint8_t grid_iy = 0;
+  if (oled_drawn_screen != GAME_STATE_IN_GAME) {
+    oled_drawn_screen = GAME_STATE_IN_GAME;
+    oled_bg_show(GAME_STATE_IN_GAME, render_tetris_game_bg);
+    // All of the cells are empty now.
     for (grid_iy = 0; grid_iy < 20; ++grid_iy) {
-      // For monochrome displays, just check empty/not empty.
-      if (tetris_grid[grid_ix][grid_iy] != TGRID_EMPTY) {
-        oled_draw_rect(48 + (grid_ix * 3),
-                       3 + (grid_iy * 3),
-                       2, 2, 0, 1);
+      tetris_drawn_rows[grid_iy] = 0x0000;
+    }
+    // The counters have not been drawn yet.
+    tetris_drawn_score = 0xFFFFFFFF;
+    tetris_drawn_lines = 0xFFFF;
+    tetris_drawn_level = 0xFF;
+  }
+
+  // Redraw the counters which changed.
+  if (tetris_score != tetris_drawn_score) {
+    tetris_drawn_score = tetris_score;
+    oled_draw_int_field_font(TETRIS_PANEL_X, 12, tetris_drawn_score,
+                             TETRIS_PANEL_W, &FONT_3X5, 1);
+  }
+  if (tetris_lines != tetris_drawn_lines) {
+    tetris_drawn_lines = tetris_lines;
+    oled_draw_int_field_font(TETRIS_PANEL_X, 31, tetris_drawn_lines,
+                             TETRIS_PANEL_W, &FONT_3X5, 1);
+  }
+  if (tetris_level != tetris_drawn_level) {
+    tetris_drawn_level = tetris_level;
+    oled_draw_int_field_font(TETRIS_PANEL_X, 50, tetris_drawn_level,
+                             TETRIS_PANEL_W, &FONT_3X5, 1);
+  }
+
+  // Find which cells are filled in this frame; the grid,
+  // plus the current brick.
+  uint16_t cur_rows[20];
+  for (grid_iy = 0; grid_iy < 20; ++grid_iy) {
+    cur_rows[grid_iy] = tetris_rows[grid_iy];
+  }
+  const brick_state_t *brick = &BRICKS[cur_block_r][cur_block_type];
+  for (grid_iy = brick->min_y; grid_iy <= brick->max_y; ++grid_iy) {
+    if (cur_block_y+grid_iy >= 0) {
+      cur_rows[cur_block_y+grid_iy] |= (brick->rows[grid_iy] << (cur_block_x + brick->min_x));
+    }
+  }
+
+  // Redraw the cells which changed.
+  for (grid_iy = 0; grid_iy < 20; ++grid_iy) {
+    uint16_t changed = cur_rows[grid_iy] ^ tetris_drawn_rows[grid_iy];
+    if (!changed) { continue; }
+    for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+      if (changed & (1 << grid_ix)) {
+        if (cur_rows[grid_iy] & (1 << grid_ix)) {
+          oled_draw_rect(48 + (grid_ix * 3),
+                         3 + (grid_iy * 3),
+                         2, 2, 0, 1);
+        }
+        else {
+          oled_bg_restore(48 + (grid_ix * 3),
+                          3 + (grid_iy * 3),
+                          2, 2);
+        }
       }
     }
+    tetris_drawn_rows[grid_iy] = cur_rows[grid_iy];
   }
+}
+
+/*
+ * Add an event to the queue, which happened at 'time' on
+ * the 'clock_us' clock. Only call this from the tasks which
+ * produce events.
+ * Returns 0 if the queue was full and the event was dropped.
+ */
+uint8_t event_push(uint8_t type, uint32_t time) {
+  uint8_t head = event_queue_head;
+  uint8_t next = (head + 1) & (EVENT_QUEUE_LEN - 1);
+  if (next == event_queue_tail) {
+    ++event_queue_dropped;
+    return 0;
+  }
+  event_queue[head].type = type;
+  event_queue[head].held = input_held;
+  event_queue[head].time = time;
+  event_queue_head = next;
+  return 1;
+}
+
+/*
+ * Take the oldest event from the queue. Only call this
+ * from the 'render' task.
+ * Returns 0 if the queue was empty.
+ */
+uint8_t event_pop(game_event_t *ev) {
+  uint8_t tail = event_queue_tail;
+  if (tail == event_queue_head) { return 0; }
+  *ev = event_queue[tail];
+  event_queue_tail = (tail + 1) & (EVENT_QUEUE_LEN - 1);
+  return 1;
+}
 
-  // Draw the current brick.
-  for (grid_ix = 0; grid_ix < 4; ++grid_ix) {
-    for (grid_iy = 0; grid_iy < 4; ++grid_iy) {
-      if ((cur_block_y+grid_iy >= 0) &&
-          (BRICKS[cur_block_r][cur_block_type] & (1 << (3-grid_ix+(3-grid_iy)*4)))) {
-        oled_draw_rect(48 + ((cur_block_x+grid_ix) * 3),
-                       3 + ((cur_block_y+grid_iy) * 3),
-                       2, 2, 0, 1);
+/*
+ * Apply one event to the game state.
+ */
+void game_handle_event(const game_event_t *ev) {
+  if (ev->type == EVENT_GAME_FRAME) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Repeat held 'Left'/'Right' moves before gravity, so
+      // that the brick can slide over gaps as it falls.
+      tetris_auto_shift(ev->held);
+      // Blink the LED each time the brick drops.
+      if (tetris_game_frame(ev->held & BUTTON_DOWN)) {
+        uled_state = !uled_state;
+      }
+    }
+  }
+  else if (ev->type == EVENT_PRESS_LEFT) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Move the brick left, if possible, and start
+      // repeating the move if the button stays held.
+      tetris_shift_brick(-1);
+      tetris_start_auto_shift(BUTTON_LEFT);
+    }
+  }
+  else if (ev->type == EVENT_PRESS_UP) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Hard drop: drop the brick onto the stack and fix it
+      // in place immediately.
+      if (tetris_hard_drop()) {
+        uled_state = !uled_state;
+      }
+    }
+    else if (game_state == GAME_STATE_MAIN_MENU) {
+      // Show or hide the frame statistics overlay.
+      frame_overlay_on = !frame_overlay_on;
+    }
+  }
+  else if (ev->type == EVENT_PRESS_DOWN) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Soft drop one row right away, so that a quick tap
+      // which is let go before the next frame still counts.
+      // Holding the button speeds up the gravity.
+      if (cur_block_y < tetris_ghost_y) {
+        cur_block_y++;
+        tetris_gravity_acc = 0;
+        tetris_lock_frames = 0;
+        uled_state = !uled_state;
       }
     }
   }
+  else if (ev->type == EVENT_PRESS_RIGHT) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Move the brick right, if possible, and start
+      // repeating the move if the button stays held.
+      tetris_shift_brick(1);
+      tetris_start_auto_shift(BUTTON_RIGHT);
+    }
+  }
+  else if (ev->type == EVENT_PRESS_B) {
+    if (game_state == GAME_STATE_IN_GAME) {
+      // Rotate the brick clockwise, if able.
+      tetris_rotate_brick((cur_block_r + 3) % 4);
+    }
+    else if (game_state == GAME_STATE_GAME_OVER) {
+      // Either the 'A' or 'B' button returns to the
+      // main menu from a 'Game Over' screen.
+      game_state = GAME_STATE_MAIN_MENU;
+      main_menu_state = MAIN_MENU_STATE_START;
+      uled_state = 0;
+      sched_stop(SCHED_TASK_GAME);
+      reset_game_state();
+    }
+  }
+  else if (ev->type == EVENT_PRESS_A) {
+    if (game_state == GAME_STATE_MAIN_MENU) {
+      if (main_menu_state == MAIN_MENU_STATE_START) {
+        // Start a new game!
+        game_state = GAME_STATE_IN_GAME;
+        uled_state = 0;
+        // Set a PRNG-based first block type.
+        uint8_t new_block_type = TIM3->CNT & 0x7;
+        // (Valid block types are between [0:6])
+        while (new_block_type == 7) { new_block_type = TIM3->CNT & 0x7; }
+        cur_block_type = new_block_type;
+        tetris_update_ghost();
+        // Start the fixed 60Hz game clock. The game speeds
+        // up by increasing the gravity per frame, not the rate.
+        sched_start(SCHED_TASK_GAME);
+      }
+    }
+    else if (game_state == GAME_STATE_IN_GAME) {
+      // Rotate the brick counter-clockwise, if able.
+      tetris_rotate_brick((cur_block_r + 1) % 4);
+    }
+    else if (game_state == GAME_STATE_GAME_OVER) {
+      game_state = GAME_STATE_MAIN_MENU;
+      main_menu_state = MAIN_MENU_STATE_START;
+      uled_state = 0;
+      sched_stop(SCHED_TASK_GAME);
+      reset_game_state();
+    }
+  }
+}
+
+/*
+ * Apply every queued event, oldest first.
+ * The main loop calls this between frames.
+ */
+void game_process_events(void) {
+  game_event_t ev;
+  while (event_pop(&ev)) {
+    game_handle_event(&ev);
+    ++game_state_seq;
+    latency_event_applied(&ev);
+  }
+}
+
+/*
+ * Start the system clock: SysTick counts down from 47999 at
+ * the core clock rate, and interrupts each time it wraps. Its
+ * interrupt should have the highest priority, so that the
+ * millisecond count is never behind the counter.
+ */
+void clock_init(void) {
+  clock_ms = 0;
+  SysTick->CTRL  =  0;
+  SysTick->LOAD  =  SYSTICK_CYCLES_PER_MS - 1;
+  SysTick->VAL   =  0;
+  SysTick->CTRL  =  (SysTick_CTRL_CLKSOURCE_Msk |
+                     SysTick_CTRL_TICKINT_Msk |
+                     SysTick_CTRL_ENABLE_Msk);
+}
+
+/*
+ * Read the cycles elapsed in the current millisecond, along
+ * with the millisecond count. The count is read again until
+ * it doesn't change, in case SysTick wrapped in between.
+ */
+static uint32_t clock_read(uint32_t *ms) {
+  uint32_t val;
+  do {
+    *ms = clock_ms;
+    val = SysTick->VAL;
+  } while (*ms != clock_ms);
+  return (SYSTICK_CYCLES_PER_MS - 1) - val;
+}
+
+/*
+ * Read the clock in core clock cycles.
+ * (The count wraps after ~89 seconds; only use differences.)
+ */
+uint32_t clock_cycles(void) {
+  uint32_t ms;
+  uint32_t cycles = clock_read(&ms);
+  return (ms * SYSTICK_CYCLES_PER_MS) + cycles;
+}
+
+/*
+ * Read the clock in microseconds.
+ * (The count wraps after ~71 minutes; only use differences.)
+ */
+uint32_t clock_us(void) {
+  uint32_t ms;
+  uint32_t cycles = clock_read(&ms);
+  // (cycles * 1365) >> 16 ~= cycles / 48, without a division.
+  return (ms * 1000) + ((cycles * 1365) >> 16);
+}
+
+/*
+ * Read the clock for measuring how long code takes to run, in
+ * microseconds. On the chip, this is 'clock_us'. The host
+ * simulator's SysTick only moves when its script lets time
+ * pass, so there this reads the host's real time instead; it
+ * never feeds the scheduler, so the simulation stays repeatable.
+ */
+uint32_t clock_run_us(void) {
+#ifdef VVC_HOST
+  return host_run_us();
+#else
+  return clock_us();
+#endif
+}
+
+/*
+ * Reset the button state. The GPIO pins should already be set
+ * up as inputs; the scheduler's 'input' task samples them.
+ */
+void input_init(void) {
+  input_held = 0;
+  input_cnt0 = 0;
+  input_cnt1 = 0;
+}
+
+/*
+ * Debounce one sample of the buttons, 1 bit per button.
+ * A button only changes state after 4 samples in a row (4ms)
+ * disagree with it; switch bounce resets its count. All of the
+ * buttons are counted at once with 2-bit 'vertical' counters.
+ * The time of the first sample in each run is kept in
+ * 'input_edge_us', so that a change can be dated from when it
+ * was first seen rather than from when it was accepted.
+ * Returns the buttons which changed state.
+ */
+uint8_t input_debounce(uint8_t raw) {
+  uint8_t held = input_held;
+  uint8_t delta = raw ^ held;
+  // Count up the buttons which disagree, and reset the others.
+  input_cnt1 = (input_cnt1 ^ input_cnt0) & delta;
+  input_cnt0 = ~input_cnt0 & delta;
+  // A count of 1 is the first sample of a run.
+  uint8_t started = input_cnt0 & ~input_cnt1;
+  if (started) {
+    uint32_t now = clock_us();
+    uint8_t pin;
+    for (pin = BUTTON_PIN_FIRST; pin <= BUTTON_PIN_LAST; ++pin) {
+      if (started & (1 << pin)) { input_edge_us[pin] = now; }
+    }
+  }
+  // A count which wrapped back to 0 has seen 4 samples.
+  uint8_t toggled = delta & ~(input_cnt0 | input_cnt1);
+  input_held = held ^ toggled;
+  return toggled;
+}
+
+/*
+ * Sample the buttons and queue an event for each new press.
+ * Each press is dated from the first sample which saw it.
+ * This is the scheduler's 'input' task, run every 1ms.
+ */
+void input_sample(void) {
+  // The buttons read low when pressed.
+  uint8_t pressed = input_debounce(~(GPIOA->IDR) & BUTTON_ALL);
+  pressed &= input_held;
+  if (!pressed) { return; }
+  uint8_t pin;
+  for (pin = BUTTON_PIN_FIRST; pin <= BUTTON_PIN_LAST; ++pin) {
+    if (pressed & (1 << pin)) {
+      event_push(pin - 1, input_edge_us[pin]);
+    }
+  }
+}
+
+/*
+ * Queue the next 60Hz game frame.
+ * This is the scheduler's 'game' task; it only runs in a game.
+ */
+void game_tick(void) {
+  ++game_frame_count;
+  event_push(EVENT_GAME_FRAME, clock_us());
+}
+
+/*
+ * Reset the frame statistics, and start a new window.
+ */
+void frame_stats_reset(void) {
+  frame_stats.window_start_us = clock_us();
+  frame_stats.frames = 0;
+  frame_stats.skipped = 0;
+  frame_stats.min_us = 0xFFFFFFFF;
+  frame_stats.max_us = 0;
+  frame_stats.total_us = 0;
+}
+
+/*
+ * Finish the statistics window if it has run its length.
+ */
+void frame_stats_update(uint32_t now) {
+  if ((now - frame_stats.window_start_us) < FRAME_STATS_WINDOW_US) {
+    return;
+  }
+  uint16_t frames = frame_stats.frames;
+  frame_stats.last_frames = frames;
+  frame_stats.last_skipped = frame_stats.skipped;
+  frame_stats.last_min_us = frames ? frame_stats.min_us : 0;
+  frame_stats.last_avg_us = frames ? (frame_stats.total_us / frames) : 0;
+  frame_stats.last_max_us = frame_stats.max_us;
+  ++frame_stats.window;
+  frame_stats_reset();
+}
+
+/*
+ * Add one frame's build time to the statistics window.
+ */
+void frame_stats_record(uint32_t us) {
+  ++frame_stats.frames;
+  frame_stats.total_us += us;
+  if (us < frame_stats.min_us) { frame_stats.min_us = us; }
+  if (us > frame_stats.max_us) { frame_stats.max_us = us; }
+}
+
+/*
+ * Check whether the debug overlay needs to be drawn; it is only
+ * redrawn when a new stats window finishes, or when the screen
+ * underneath it is drawn from scratch.
+ */
+uint8_t frame_overlay_stale(void) {
+  if (!frame_overlay_on) {
+    // Erase it if it was showing.
+    return frame_overlay_screen != OLED_SCREEN_NONE;
+  }
+  return (frame_overlay_screen != oled_drawn_screen ||
+          frame_overlay_window != frame_stats.window);
+}
+
+/*
+ * Draw (or erase) the debug overlay, after the rest of the frame.
+ */
+void draw_frame_overlay(void) {
+  if (!frame_overlay_on) {
+    oled_draw_rect(FRAME_OVERLAY_X, 0, FRAME_OVERLAY_W,
+                   FRAME_OVERLAY_ROWS * FRAME_OVERLAY_ROW_H, 0, 0);
+    frame_overlay_screen = OLED_SCREEN_NONE;
+    return;
+  }
+  uint32_t values[FRAME_OVERLAY_ROWS] = {
+    frame_stats.last_frames,
+    frame_stats.last_skipped,
+    frame_stats.last_min_us,
+    frame_stats.last_avg_us,
+    frame_stats.last_max_us,
+  };
+  uint8_t row;
+  for (row = 0; row < FRAME_OVERLAY_ROWS; ++row) {
+    // (4 digits fit in the margin.)
+    int value = (values[row] > 9999) ? 9999 : values[row];
+    oled_draw_int_field_font(FRAME_OVERLAY_X,
+                             1 + (row * FRAME_OVERLAY_ROW_H),
+                             value, FRAME_OVERLAY_W, &FONT_3X5, 1);
+  }
+  frame_overlay_screen = oled_drawn_screen;
+  frame_overlay_window = frame_stats.window;
+}
+
+/*
+ * Apply the queued events, and draw and present the next frame
+ * if anything changed. This is the scheduler's 'render' task,
+ * released once per 'FRAME_TARGET_US'. Frames are always drawn
+ * into the back buffer, even while the previous one is still
+ * being sent; only presenting waits for the bus. A frame which
+ * can't be presented yet is left pending, and goes out with the
+ * next release. If another frame is drawn on top of it first,
+ * it counts as skipped.
+ */
+void game_render(void) {
+  uint32_t now = clock_us();
+  uint32_t start = clock_run_us();
+  uint8_t drawn = 0;
+  frame_stats_update(now);
+  game_process_events();
+  // Set the onboard LED if the variable is set.
+  if (uled_state) {
+    GPIOA->ODR |=  (GPIO_ODR_12);
+  }
+  else {
+    GPIOA->ODR &= ~(GPIO_ODR_12);
+  }
+  if (game_state_seq != drawn_state_seq || frame_overlay_stale()) {
+    if (oled_present_pending) {
+      // The last frame was never sent; this one replaces it.
+      ++frame_stats.skipped;
+    }
+    draw_frame();
+    if (frame_overlay_stale()) {
+      draw_frame_overlay();
+    }
+    oled_present_pending = 1;
+    drawn = 1;
+  }
+  if (oled_present_pending && oled_fb_dma_state == OLED_FB_DMA_IDLE) {
+    oled_present(I2C1);
+    oled_present_pending = 0;
+  }
+  if (drawn) {
+    frame_stats_record(clock_run_us() - start);
+  }
+}
+
+/*
+ * Set the starting values for global variables.
+ */
+void game_init(void) {
+  uled_state = 0;
+  oled_fb_dma_state = OLED_FB_DMA_IDLE;
+  oled_present_pending = 0;
+  i2c_dma_bytes_left = 0;
+  oled_fb = oled_fb_bufs[0];
+  oled_fb_front = oled_fb_bufs[1];
+  oled_drawn_screen = OLED_SCREEN_NONE;
+  oled_bg_screen = OLED_SCREEN_NONE;
+  oled_text_cache_clear();
+  oled_clear_dirty();
+  game_state = GAME_STATE_MAIN_MENU;
+  main_menu_state = MAIN_MENU_STATE_START;
+  game_state_seq = 1;
+  drawn_state_seq = 0;
+  event_queue_head = 0;
+  event_queue_tail = 0;
+  event_queue_dropped = 0;
+  game_frame_count = 0;
+  latency_reset();
+  frame_stats.window = 0;
+  frame_stats.last_frames = 0;
+  frame_stats.last_skipped = 0;
+  frame_stats.last_min_us = 0;
+  frame_stats.last_avg_us = 0;
+  frame_stats.last_max_us = 0;
+  frame_stats_reset();
+  frame_overlay_on = 0;
+  frame_overlay_screen = OLED_SCREEN_NONE;
+  frame_overlay_window = 0;
+  cur_block_type = TBRICK_I;
+  // Empty the tetris grid, to start.
+  reset_game_state();
 }
 
 /*
@@ -661,136 +1510,281 @@ void reset_game_state(void) {
       tetris_grid[grid_ix][grid_iy] = TGRID_EMPTY;
     }
   }
+  for (grid_iy = 0; grid_iy < 20; ++grid_iy) {
+    tetris_rows[grid_iy] = 0x0000;
+  }
+  // Reset the score and level.
+  tetris_score = 0;
+  tetris_lines = 0;
+  tetris_level = 0;
+  tetris_level_lines_left = TETRIS_LINES_PER_LEVEL;
+  tetris_gravity_acc = 0;
+  tetris_lock_frames = 0;
+  tetris_das_button = 0;
+  tetris_das_frames = 0;
+  tetris_update_ghost();
 }
 
 /*
- * Check whether the current brick can rotate into a given
- * position. Return 1 if there is a collision, 0 if it can rotate.
+ * Check whether a brick fits at a given position and rotation.
+ * The walls and floor are checked against the brick's extents,
+ * and then each of its rows is tested against the grid's
+ * occupancy row with a single AND.
+ * Rows above the top of the grid are not checked.
+ * Return 1 if there is a collision, 0 if the brick fits.
  */
-uint8_t check_brick_rot(int8_t new_r) {
-  uint8_t grid_ix = 0;
-  uint8_t grid_iy = 0;
-  for (grid_ix = 0; grid_ix < 4; ++grid_ix) {
-    for (grid_iy = 0; grid_iy < 4; ++grid_iy) {
-      if ((cur_block_y+grid_iy >= 0) &&
-          (BRICKS[new_r][cur_block_type] & (1 << (3-grid_ix+(3-grid_iy)*4))) &&
-          ((cur_block_y+grid_iy > 19) ||
-           (cur_block_x+grid_ix < 0) ||
-           (cur_block_x+grid_ix > 9) ||
-           (tetris_grid[cur_block_x+grid_ix][cur_block_y+grid_iy] != TGRID_EMPTY))) {
-        return 1;
-      }
+uint8_t check_brick_fit(uint8_t type, int8_t r, int8_t xp, int8_t yp) {
+  const brick_state_t *brick = &BRICKS[r][type];
+  int8_t grid_iy;
+  if ((xp + brick->min_x < 0) ||
+      (xp + brick->max_x > 9) ||
+      (yp + brick->max_y > 19)) {
+    return 1;
+  }
+  for (grid_iy = brick->min_y; grid_iy <= brick->max_y; ++grid_iy) {
+    if ((yp + grid_iy >= 0) &&
+        (tetris_rows[yp + grid_iy] & (brick->rows[grid_iy] << (xp + brick->min_x)))) {
+      return 1;
     }
   }
   return 0;
 }
 
+/*
+ * Check whether the current brick can rotate into a given
+ * position. Return 1 if there is a collision, 0 if it can rotate.
+ */
+uint8_t check_brick_rot(int8_t new_r) {
+  return check_brick_fit(cur_block_type, new_r, cur_block_x, cur_block_y);
+}
+
 /*
  * Check whether the current brick can move into a
  * given grid coordinate.
  * Return 1 if there is a collision, 0 if the space is free.
  */
 uint8_t check_brick_pos(int8_t xp, int8_t yp) {
-  uint8_t grid_ix = 0;
-  uint8_t grid_iy = 0;
-  for (grid_ix = 0; grid_ix < 4; ++grid_ix) {
-    for (grid_iy = 0; grid_iy < 4; ++grid_iy) {
-      if ((yp+grid_iy >= 0) &&
-          (BRICKS[cur_block_r][cur_block_type] & (1 << (3-grid_ix+(3-grid_iy)*4))) &&
-          ((yp+grid_iy > 19) || (xp+grid_ix < 0) ||
-           (xp+grid_ix > 9) ||
-           (tetris_grid[xp+grid_ix][yp+grid_iy] != TGRID_EMPTY))) {
-        return 1;
+  return check_brick_fit(cur_block_type, cur_block_r, xp, yp);
+}
+
+/*
+ * Clear every full row in the tetris grid in a single pass.
+ * Rows are scanned bottom-up; each row which isn't full is
+ * copied down to a 'write' cursor, and the rows left over at
+ * the top are emptied. The indices of the cleared rows (as
+ * they were before clearing, bottom-up) are written to
+ * 'cleared_rows', which needs room for 4 entries.
+ * Returns the number of rows which were cleared.
+ */
+uint8_t tetris_clear_full_rows(uint8_t *cleared_rows) {
+  int8_t read_iy;
+  int8_t write_iy = 19;
+  uint8_t grid_ix;
+  uint8_t num_cleared = 0;
+  for (read_iy = 19; read_iy >= 0; --read_iy) {
+    if (tetris_rows[read_iy] == TROW_FULL) {
+      cleared_rows[num_cleared] = read_iy;
+      ++num_cleared;
+      continue;
+    }
+    if (write_iy != read_iy) {
+      for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+        tetris_grid[grid_ix][write_iy] = tetris_grid[grid_ix][read_iy];
       }
+      tetris_rows[write_iy] = tetris_rows[read_iy];
     }
+    --write_iy;
   }
-  return 0;
+  // Empty the rows at the top which nothing moved into.
+  for (; write_iy >= 0; --write_iy) {
+    for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
+      tetris_grid[grid_ix][write_iy] = TGRID_EMPTY;
+    }
+    tetris_rows[write_iy] = 0x0000;
+  }
+  return num_cleared;
 }
 
 /*
- * Clear a row in the tetris grid, and shift the rows above down.
+ * Return a level's gravity, in 16.16 fixed-point 'G'.
  */
-void tetris_clear_row(uint8_t row_num) {
-  uint8_t grid_ix;
-  uint8_t grid_iy;
-  // For each row (starting at the row to clear,)
-  // replace it with the row above and move up 1.
-  for (grid_iy = row_num; grid_iy > 0; --grid_iy) {
-    for (grid_ix = 0; grid_ix < 9; ++grid_ix) {
-      tetris_grid[grid_ix][grid_iy] = tetris_grid[grid_ix][grid_iy-1];
-    }
+uint32_t tetris_gravity(uint8_t level) {
+  if (level >= TETRIS_GRAVITY_LEVELS) {
+    level = TETRIS_GRAVITY_LEVELS - 1;
+  }
+  return TETRIS_GRAVITY[level];
+}
+
+/*
+ * Score a line clear and advance the level every
+ * 'TETRIS_LINES_PER_LEVEL' lines. The game clock's rate
+ * stays the same; a new level only changes the gravity which
+ * is added to the accumulator each frame.
+ */
+void tetris_add_cleared_lines(uint8_t num_cleared) {
+  if (!num_cleared) { return; }
+  tetris_score += TETRIS_LINE_SCORES[num_cleared] * (tetris_level + 1);
+  tetris_lines += num_cleared;
+  if (num_cleared >= tetris_level_lines_left) {
+    tetris_level_lines_left += TETRIS_LINES_PER_LEVEL - num_cleared;
+    ++tetris_level;
   }
-  // For row 0, just set all cells to empty.
-  for (grid_ix = 0; grid_ix < 9; ++grid_ix) {
-    tetris_grid[grid_ix][0] = TGRID_EMPTY;
+  else {
+    tetris_level_lines_left -= num_cleared;
   }
 }
 
 /*
- * Main 'tick' for the Tetris game loop.
- * This performs one 'step' in the game, either dropping a brick
- * or setting it in place and clearing rows/creating the next one.
+ * Fix the current brick in place on the grid, clear and score
+ * any full rows, and create the next brick.
+ * The game is over if part of the brick is above the top line.
  */
-void tetris_game_tick(void) {
+void tetris_lock_brick(void) {
   int8_t grid_ix = 0;
   int8_t grid_iy = 0;
-  unsigned char can_drop = 1;
-  /* Step 1:  Try to drop the current brick by 1 cell. */
-  if (check_brick_pos(cur_block_x, cur_block_y+1)) {
-    can_drop = 0;
+  const brick_state_t *brick = &BRICKS[cur_block_r][cur_block_type];
+  uint8_t cell_i;
+  for (cell_i = 0; cell_i < 4; ++cell_i) {
+    grid_ix = cur_block_x + (brick->cells[cell_i] & 0x0F);
+    grid_iy = cur_block_y + (brick->cells[cell_i] >> 4);
+    if (grid_iy < 0) {
+      // Game over
+      game_state = GAME_STATE_GAME_OVER;
+      uled_state = 0;
+      sched_stop(SCHED_TASK_GAME);
+    }
+    else {
+      tetris_grid[grid_ix][grid_iy] = cur_block_type;
+      tetris_rows[grid_iy] |= (1 << grid_ix);
+    }
   }
 
-  if (can_drop) {
-    /* Step 2a: If the current brick can drop, do so. */
-    cur_block_y++;
+  // Clear any appropriate rows, and score them.
+  tetris_num_cleared = tetris_clear_full_rows(tetris_cleared_rows);
+  tetris_add_cleared_lines(tetris_num_cleared);
+
+  // Create a new 'current brick'.
+  uint8_t new_block_type = TIM3->CNT & 0x7;
+  // (Valid block types are between [0:6])
+  while (new_block_type == 7) { new_block_type = TIM3->CNT & 0x7; }
+  cur_block_type = new_block_type;
+  cur_block_x = 4;
+  cur_block_y = -1;
+  cur_block_r = 0;
+  tetris_gravity_acc = 0;
+  tetris_lock_frames = 0;
+  tetris_update_ghost();
+}
+
+/*
+ * Find the row which the current brick would land on if it
+ * dropped straight down. This has to be called whenever the
+ * brick moves sideways, rotates or is replaced; dropping it
+ * doesn't change where it will land.
+ */
+void tetris_update_ghost(void) {
+  int8_t ghost_y = cur_block_y;
+  while (!check_brick_pos(cur_block_x, ghost_y+1)) {
+    ++ghost_y;
   }
-  else {
-    /* Step 2b: If the current brick cannot drop, fix it
-     *          in the main Tetris grid. */
-    for (grid_ix = 0; grid_ix < 4; ++grid_ix) {
-      for (grid_iy = 0; grid_iy < 4; ++grid_iy) {
-        if (BRICKS[cur_block_r][cur_block_type] & (1 << (3-grid_ix+(3-grid_iy)*4))) {
-          if (cur_block_y+grid_iy < 0) {
-            // Game over
-            game_state = GAME_STATE_GAME_OVER;
-            uled_state = 0;
-            stop_timer(TIM2);
-          }
-          else {
-            tetris_grid[cur_block_x+grid_ix][cur_block_y+grid_iy] = cur_block_type;
-          }
-        }
-      }
-    }
+  tetris_ghost_y = ghost_y;
+}
 
-    /* Step 3b: Clear any appropriate rows. */
-    grid_iy = 19;
-    uint8_t row_has_space = 0;
-    while (grid_iy >= 0) {
-      row_has_space = 0;
-      // If the row is full, clear it and move all the
-      // rows above it down by one.
-      for (grid_ix = 0; grid_ix < 10; ++grid_ix) {
-        if (tetris_grid[grid_ix][grid_iy] == TGRID_EMPTY) {
-          row_has_space = 1;
-        }
-      }
-      if (!row_has_space) {
-        tetris_clear_row(grid_iy);
-      }
-      // If not, move to the next row.
-      else {
-        grid_iy--;
-      }
+/*
+ * Move the current brick sideways by 'dx' columns, if it fits.
+ * Return 1 if the brick moved.
+ */
+uint8_t tetris_shift_brick(int8_t dx) {
+  if (check_brick_pos(cur_block_x+dx, cur_block_y)) { return 0; }
+  cur_block_x += dx;
+  tetris_update_ghost();
+  return 1;
+}
+
+/*
+ * Rotate the current brick to rotation 'new_r', if it fits.
+ * Return 1 if the brick rotated.
+ */
+uint8_t tetris_rotate_brick(int8_t new_r) {
+  if (check_brick_rot(new_r)) { return 0; }
+  cur_block_r = new_r;
+  tetris_update_ghost();
+  return 1;
+}
+
+/*
+ * Start auto-shifting for a 'Left' or 'Right' button which was
+ * just pressed. The most recently pressed direction wins.
+ */
+void tetris_start_auto_shift(uint8_t button) {
+  tetris_das_button = button;
+  tetris_das_frames = 0;
+}
+
+/*
+ * Count one frame of delayed auto-shift, given the buttons which
+ * are held down. Once the button has been held for the DAS delay,
+ * the brick moves every 'TETRIS_ARR_FRAMES'. The count keeps going
+ * while the brick is against a wall, so that it moves as soon as
+ * there is room.
+ */
+void tetris_auto_shift(uint8_t held) {
+  if (!(held & tetris_das_button)) {
+    tetris_das_button = 0;
+    return;
+  }
+  if (++tetris_das_frames >= TETRIS_DAS_FRAMES) {
+    tetris_das_frames = TETRIS_DAS_FRAMES - TETRIS_ARR_FRAMES;
+    tetris_shift_brick((tetris_das_button == BUTTON_LEFT) ? -1 : 1);
+  }
+}
+
+/*
+ * Drop the current brick onto the stack and fix it in place.
+ * Return the number of rows that it dropped.
+ */
+uint8_t tetris_hard_drop(void) {
+  uint8_t rows_dropped = tetris_ghost_y - cur_block_y;
+  cur_block_y = tetris_ghost_y;
+  tetris_lock_brick();
+  return rows_dropped;
+}
+
+/*
+ * Main 'frame' for the Tetris game loop, run at a fixed 60Hz.
+ * This adds the level's gravity to the accumulator and drops
+ * the brick by one row for each whole 'G' in it, so that any
+ * speed from a row every few seconds up to 20G takes the same
+ * fixed-rate clock. A brick which can't drop is fixed in place
+ * once its lock delay runs out. 'soft_drop' is set while the
+ * 'Down' button is held.
+ * Returns the number of rows that the brick dropped.
+ */
+uint8_t tetris_game_frame(uint8_t soft_drop) {
+  uint8_t rows_dropped = 0;
+  uint32_t gravity = tetris_gravity(tetris_level);
+  if (soft_drop && gravity < TETRIS_SOFT_DROP_G) {
+    gravity = TETRIS_SOFT_DROP_G;
+  }
+  tetris_gravity_acc += gravity;
+  while (tetris_gravity_acc >= TETRIS_G_ONE) {
+    if (cur_block_y >= tetris_ghost_y) {
+      // Resting on the stack; don't bank any more gravity.
+      tetris_gravity_acc = 0;
+      break;
     }
+    tetris_gravity_acc -= TETRIS_G_ONE;
+    cur_block_y++;
+    rows_dropped++;
+  }
 
-    /* Step 4b: Create a new 'current brick'. */
-    uint8_t new_block_type = TIM3->CNT & 0x7;
-    // (Valid block types are between [0:6])
-    while (new_block_type == 7) { new_block_type = TIM3->CNT & 0x7; }
-    cur_block_type = new_block_type;
-    cur_block_x = 4;
-    cur_block_y = -1;
-    cur_block_r = 0;
+  if (rows_dropped) {
+    tetris_lock_frames = 0;
+  }
+  if (cur_block_y >= tetris_ghost_y) {
+    if (++tetris_lock_frames >= TETRIS_LOCK_DELAY_FRAMES) {
+      tetris_lock_brick();
+    }
   }
+  return rows_dropped;
 }
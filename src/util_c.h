@@ -2,34 +2,109 @@
 #define _VVC_UTIL_C_H
 
 #include "global.h"
+#include "latency.h"
+#include "sched.h"
 #include "peripherals.h"
 
 // C-languages utility method signatures.
 
 // Methods for interacting with specific I2C devices.
 void ssd1306_start_sequence(I2C_TypeDef *I2Cx);
+void ssd1306_update(I2C_TypeDef *I2Cx);
+void ssd1306_update_next(I2C_TypeDef *I2Cx);
+
+// Methods for presenting a finished frame.
+void oled_present(I2C_TypeDef *I2Cx);
+
+// Methods for tracking which parts of the framebuffer changed.
+void oled_mark_dirty(int x, int y, int w, int h);
+void oled_mark_all_dirty(void);
+void oled_clear_dirty(void);
+
+// Whole-buffer fill and copy methods. These don't mark
+// anything as dirty, since they can act on any buffer.
+void fb_fill(unsigned char *fb, unsigned char value);
+void fb_clear(unsigned char *fb);
+void fb_copy(unsigned char *dst, const unsigned char *src);
+
+// Methods for the pre-rendered background layer.
+void oled_bg_show(uint8_t screen, void (*render)(void));
+void oled_bg_restore(int x, int y, int w, int h);
 
 // Methods for writing to the 1KB OLED framebuffer.
-// These don't actually write through to the screen until
-// the 'i2c_display_framebuffer' method is called (see util.S)
+// They draw to the 'back' buffer, which doesn't get sent to
+// the screen until the 'oled_present' method is called.
+void oled_fill_span(int x, int y, int w, int h, unsigned char color);
 void oled_draw_h_line(int x, int y, int w, unsigned char color);
 void oled_draw_v_line(int x, int y, int h, unsigned char color);
 void oled_draw_rect(int x, int y, int w, int h,
                     int outline, unsigned char color);
 void oled_write_pixel(int x, int y, unsigned char color);
+const uint8_t *oled_glyph(char c);
+void oled_draw_glyph(int x, int y, const uint8_t *cols, unsigned char color, char size);
 void oled_draw_letter(int x, int y, unsigned int w0, unsigned int w1, unsigned char color, char size);
 void oled_draw_letter_c(int x, int y, char c, unsigned char color, char size);
 void oled_draw_letter_i(int x, int y, int ic, unsigned char color, char size);
+int oled_format_int(char *buf, int val, uint8_t width, char pad);
+void oled_draw_int_field(int x, int y, int ic, uint8_t width, unsigned char color, char size);
 void oled_draw_text(int x, int y, char* cc, unsigned char color, char size);
 
+// Methods for caching rasterised text.
+void oled_text_cache_clear(void);
+void oled_text_cache_invalidate(const char *cc);
+void oled_draw_text_cached(int x, int y, const char *cc, unsigned char color, char size);
+
+// Methods for drawing text in the generated proportional fonts.
+int oled_text_width(const char *cc, const font_t *font);
+int oled_draw_text_font(int x, int y, const char *cc, const font_t *font, unsigned char color);
+void oled_draw_int_field_font(int x, int y, int ic, int field_w, const font_t *font, unsigned char color);
+
+// Methods for the task-to-renderer event queue.
+uint8_t event_push(uint8_t type, uint32_t time);
+uint8_t event_pop(game_event_t *ev);
+void game_handle_event(const game_event_t *ev);
+void game_process_events(void);
+void game_tick(void);
+void game_render(void);
+
+// Methods for frame pacing statistics and their overlay.
+void frame_stats_reset(void);
+void frame_stats_update(uint32_t now);
+void frame_stats_record(uint32_t us);
+uint8_t frame_overlay_stale(void);
+void draw_frame_overlay(void);
+
+// Methods for the SysTick system clock.
+void clock_init(void);
+uint32_t clock_cycles(void);
+uint32_t clock_us(void);
+uint32_t clock_run_us(void);
+
+// Methods for sampling and debouncing the buttons.
+void input_init(void);
+uint8_t input_debounce(uint8_t raw);
+void input_sample(void);
+
 // Tetris methods!
+void draw_frame(void);
 void draw_main_menu(void);
 void draw_game_over(void);
 void draw_tetris_game(void);
+void game_init(void);
 void reset_game_state(void);
+uint8_t check_brick_fit(uint8_t type, int8_t r, int8_t xp, int8_t yp);
 uint8_t check_brick_rot(int8_t new_r);
 uint8_t check_brick_pos(int8_t xp, int8_t yp);
-void tetris_clear_row(uint8_t row_num);
-void tetris_game_tick(void);
+uint8_t tetris_clear_full_rows(uint8_t *cleared_rows);
+uint32_t tetris_gravity(uint8_t level);
+void tetris_add_cleared_lines(uint8_t num_cleared);
+void tetris_lock_brick(void);
+void tetris_update_ghost(void);
+uint8_t tetris_shift_brick(int8_t dx);
+uint8_t tetris_rotate_brick(int8_t new_r);
+void tetris_auto_shift(uint8_t held);
+void tetris_start_auto_shift(uint8_t button);
+uint8_t tetris_hard_drop(void);
+uint8_t tetris_game_frame(uint8_t soft_drop);
 
 #endif
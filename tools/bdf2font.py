@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+Generate proportional font data for the OLED from BDF sources.
+
+Usage:
+  bdf2font.py -o src/font_data.h -c src/font_data.c \
+      NAME=fonts/font.bdf[:scale] ...
+
+Each NAME=... argument emits one 'font_t' called NAME. The header
+only declares the fonts; their data is defined once, in the source
+file, so that it is not copied into every file which includes it. Glyphs are
+stored as packed column data in the framebuffer's layout (top pixel
+in bit 0, 1 byte per column for fonts up to 8px tall and 2 bytes,
+low page first, for fonts up to 16px tall). Blank columns on either
+side of a glyph are trimmed, and each glyph gets its own advance
+width, so text can be drawn proportionally. A 'scale' of N bakes an
+Nx-scaled copy of the font into the data, so no scaling is needed
+when drawing.
+"""
+
+import argparse
+import os
+import sys
+
+
+def parse_bdf(path):
+    """Return (ascent, descent, {encoding: (dwidth, bbx, rows)})."""
+    ascent = None
+    descent = None
+    glyphs = {}
+    with open(path) as f:
+        lines = [l.strip() for l in f]
+    i = 0
+    while i < len(lines):
+        words = lines[i].split()
+        if not words:
+            i += 1
+            continue
+        if words[0] == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif words[0] == 'FONT_DESCENT':
+            descent = int(words[1])
+        elif words[0] == 'STARTCHAR':
+            enc = None
+            dwidth = 0
+            bbx = (0, 0, 0, 0)
+            i += 1
+            while not lines[i].startswith('BITMAP'):
+                w = lines[i].split()
+                if w[0] == 'ENCODING':
+                    enc = int(w[1])
+                elif w[0] == 'DWIDTH':
+                    dwidth = int(w[1])
+                elif w[0] == 'BBX':
+                    bbx = tuple(int(v) for v in w[1:5])
+                i += 1
+            i += 1
+            bits = []
+            while lines[i] != 'ENDCHAR':
+                bits.append(lines[i])
+                i += 1
+            if enc is not None and enc >= 0:
+                glyphs[enc] = (dwidth, bbx, bits)
+        i += 1
+    if ascent is None or descent is None:
+        sys.exit('%s: missing FONT_ASCENT/FONT_DESCENT' % path)
+    return ascent, descent, glyphs
+
+
+def glyph_columns(ascent, height, dwidth, bbx, bits):
+    """Render a glyph into a list of column bitmasks (bit 0 = top)."""
+    w, h, xoff, yoff = bbx
+    ncols = max(dwidth, xoff + w)
+    cols = [0] * max(ncols, 0)
+    for r, row_hex in enumerate(bits):
+        row_bits = int(row_hex, 16)
+        row_len = len(row_hex) * 4
+        y = ascent - (yoff + h) + r
+        if y < 0 or y >= height:
+            continue
+        for k in range(w):
+            if row_bits & (1 << (row_len - 1 - k)):
+                x = xoff + k
+                if 0 <= x < len(cols):
+                    cols[x] |= (1 << y)
+    return cols
+
+
+def scale_column(col, height, scale):
+    out = 0
+    for y in range(height):
+        if col & (1 << y):
+            for s in range(scale):
+                out |= 1 << ((y * scale) + s)
+    return out
+
+
+def build_font(path, scale, spacing):
+    ascent, descent, glyphs = parse_bdf(path)
+    height = ascent + descent
+    if height * scale > 16:
+        sys.exit('%s: fonts taller than 16px are not supported' % path)
+    first = min(c for c in glyphs if c >= 0x20)
+    last = max(c for c in glyphs if c < 0x7F)
+    default_adv = glyphs[0x20][0] if 0x20 in glyphs else height // 2
+    col_bytes = 1 if (height * scale) <= 8 else 2
+    data = []
+    table = []
+    for enc in range(first, last + 1):
+        if enc not in glyphs:
+            table.append((len(data), 0, default_adv * scale, enc))
+            continue
+        dwidth, bbx, bits = glyphs[enc]
+        cols = glyph_columns(ascent, height, dwidth, bbx, bits)
+        ink = [i for i, c in enumerate(cols) if c]
+        if not ink:
+            table.append((len(data), 0, dwidth * scale, enc))
+            continue
+        cols = cols[ink[0]:ink[-1] + 1]
+        offset = len(data)
+        for c in cols:
+            c = scale_column(c, height, scale)
+            for s in range(scale):
+                for b in range(col_bytes):
+                    data.append((c >> (b * 8)) & 0xFF)
+        width = len(cols) * scale
+        table.append((offset, width, width + (spacing * scale), enc))
+    return {
+        'height': height * scale,
+        'first': first,
+        'last': last,
+        'data': data,
+        'glyphs': table,
+    }
+
+
+def char_comment(enc):
+    c = chr(enc)
+    if c in '\\\'':
+        return "'\\%s'" % c
+    return "'%s'" % c
+
+
+def emit_banner(out):
+    out.write('/*\n')
+    out.write(' * Font data generated by tools/bdf2font.py; do not edit.\n')
+    out.write(' * Regenerate it with \'make fonts\'.\n')
+    out.write(' */\n')
+
+
+def emit_header(out, specs, fonts):
+    emit_banner(out)
+    out.write('#ifndef _VVC_FONT_DATA_H\n')
+    out.write('#define _VVC_FONT_DATA_H\n')
+    out.write('\n')
+    for (name, path, scale), font in zip(specs, fonts):
+        out.write('// %s: %s, %dx, %dpx tall.\n' %
+                  (name, os.path.basename(path), scale, font['height']))
+        out.write('extern const font_t %s;\n' % name)
+    out.write('\n#endif\n')
+
+
+def emit_source(out, specs, fonts):
+    emit_banner(out)
+    out.write('#include "global.h"\n')
+    for (name, path, scale), font in zip(specs, fonts):
+        out.write('\n// %s: %s, %dx, %dpx tall, %d bytes of column data.\n' %
+                  (name, os.path.basename(path), scale, font['height'],
+                   len(font['data'])))
+        out.write('static const uint8_t %s_DATA[] = {\n' % name)
+        data = font['data']
+        for i in range(0, len(data), 12):
+            out.write('  ' + ', '.join('0x%02X' % b for b in data[i:i + 12]) +
+                      ',\n')
+        out.write('};\n')
+        out.write('static const font_glyph_t %s_GLYPHS[] = {\n' % name)
+        for offset, width, advance, enc in font['glyphs']:
+            out.write('  { %4d, %2d, %2d }, // %s\n' %
+                      (offset, width, advance, char_comment(enc)))
+        out.write('};\n')
+        out.write('const font_t %s = {\n' % name)
+        out.write('  %d, 0x%02X, 0x%02X, %s_GLYPHS, %s_DATA\n' %
+                  (font['height'], font['first'], font['last'], name, name))
+        out.write('};\n')
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('-o', '--output', required=True,
+                    help='header file, which declares the fonts')
+    ap.add_argument('-c', '--source', required=True,
+                    help='source file, which defines the font data')
+    ap.add_argument('--spacing', type=int, default=1,
+                    help='blank columns after each glyph, before scaling')
+    ap.add_argument('fonts', nargs='+', metavar='NAME=FILE[:SCALE]')
+    args = ap.parse_args()
+    specs = []
+    for spec in args.fonts:
+        name, _, rest = spec.partition('=')
+        path, _, scale = rest.partition(':')
+        specs.append((name, path, int(scale) if scale else 1))
+    fonts = [build_font(path, scale, args.spacing) for _, path, scale in specs]
+    with open(args.output, 'w') as out:
+        emit_header(out, specs, fonts)
+    with open(args.source, 'w') as out:
+        emit_source(out, specs, fonts)
+
+
+if __name__ == '__main__':
+    main()